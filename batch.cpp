@@ -0,0 +1,284 @@
+#include "batch.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <memory>
+#include <set>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "graph.h"
+#include "hypergraph2.h"
+#include "parser.h"
+#include "snapshot.h"
+#include "relaxation.h"
+#include "thread_pool.h"
+#include "profile.h"
+
+namespace {
+
+bool hasExtension(const std::string& filename, const std::string& extension){
+    return filename.size() >= extension.size() &&
+           filename.compare(filename.size() - extension.size(), extension.size(), extension) == 0;
+}
+
+std::string baseName(const std::string& path){
+    auto slash = path.find_last_of('/');
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+// Empty field for values a solver did not report
+std::string field(double value){
+    if (value < 0) return "";
+    std::ostringstream stream;
+    stream << value;
+    return stream.str();
+}
+
+std::string csvHeader(const std::string& task){
+    if (task == "properties") {
+        return "Name,Vertices,Edges,Density,Max Degree,Lower Bound,Upper Bound,Triangles,Average Degree,Std Dev Degree";
+    }
+    if (task == "reductions") {
+        return "Name,Isolated,Single Edge,Dominating Edge,Dominating Vertex,Counting Rule,Set Size,Time (s)";
+    }
+    return "Name,Solution Size,Time Taken (seconds),Exec Time (seconds)";
+}
+
+std::string propertiesRow(const std::string& path, int threads){
+    // A hyperedge line would be read as an edge between its first two vertices
+    if (hasExtension(path, ".hgr")) {
+        throw std::runtime_error("graph properties need a .gr instance, skipping hypergraph");
+    }
+
+    auto graph = [&]() {
+        ProfileSpan span("read");
+        return readGraphFromFile(path);
+    }();
+
+    ProfileSpan span("properties");
+    auto properties = graph.computeProperties(threads);
+
+    std::ostringstream row;
+    row << baseName(path) << ","
+        << properties.vertices << ","
+        << properties.edges << ","
+        << properties.density << ","
+        << properties.maxDegree << ","
+        << properties.lowerBound << ","
+        << properties.upperBound << ","
+        << properties.triangles << ","
+        << properties.avgDegree << ","
+        << properties.stdDevDegree;
+    return row.str();
+}
+
+std::string reductionsRow(const std::string& path){
+    auto start = std::chrono::high_resolution_clock::now();
+
+    auto hypergraph = [&]() {
+        ProfileSpan span("read");
+        return readHypergraphFromFile(path);
+    }();
+
+    std::set<int> dominatingSet;
+    ReductionCounts usage;
+    {
+        ProfileSpan span("reduce");
+        usage = hypergraph.reduceExhaustively(dominatingSet, false);
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsedSec = std::chrono::duration<double>(end - start).count();
+
+    std::ostringstream row;
+    row << baseName(path) << ","
+        << usage.isolatedVertex << ","
+        << usage.singleEdgeVertex << ","
+        << usage.dominatingEdge << ","
+        << usage.dominatingVertex << ","
+        << usage.countingRule << ","
+        << dominatingSet.size() << ","
+        << elapsedSec;
+    return row.str();
+}
+
+// findminhs reads the plain graph again, so a kernel would not reach it
+Kernel solverInput(const std::string& path, const std::string& solver, const BatchOptions& options){
+    bool reduce = options.reduce && solver != "findminhs";
+    if (reduce && !options.kernelDir.empty()) {
+        ProfileSpan span("load kernel");
+        return loadOrReduceKernel(path, options.kernelDir);
+    }
+
+    Kernel kernel = [&]() {
+        ProfileSpan span("read");
+        return Kernel{readHypergraphFromFile(path), {}, {}};
+    }();
+    if (reduce) {
+        ProfileSpan span("reduce");
+        std::set<int> dominatingSet;
+        kernel.hypergraph.reduceExhaustively(dominatingSet, false);
+        kernel.forced.assign(dominatingSet.begin(), dominatingSet.end());
+    }
+    return kernel;
+}
+
+std::string solverRow(const std::string& path, const std::string& solver, const BatchOptions& options){
+    auto kernel = solverInput(path, solver, options);
+    SolverOptions solverOptions = options.solver;
+
+    // The LP stage runs after loading, so cached snapshots stay purely combinatorial
+    if (options.relaxation && options.reduce && solver != "findminhs") {
+        ProfileSpan span("lp reduce");
+        std::set<int> fixed(kernel.forced.begin(), kernel.forced.end());
+        auto relaxation = reduceByRelaxation(kernel.hypergraph, fixed, RelaxationOptions());
+        kernel.forced.assign(fixed.begin(), fixed.end());
+        solverOptions.lowerBound = relaxation.lowerBound;
+    }
+
+    SolverResult result;
+    {
+        ProfileSpan span("solve");
+        result = runSolver(solver, path, kernel.hypergraph, solverOptions);
+    }
+    if (options.solver.verbose) std::cerr << result.output;
+
+    double solutionSize = result.solutionSize;
+    if (!result.solution.empty()) solutionSize = liftSolution(kernel, result.solution).size();
+    else if (solutionSize >= 0) solutionSize += kernel.forced.size();
+
+    std::ostringstream row;
+    row << baseName(path) << ","
+        << field(solutionSize) << ","
+        << field(result.time) << ","
+        << result.wallTime;
+    return row.str();
+}
+
+// Next to <task>.csv go <task>_profile.csv with the totals and <task>_trace.json with the timeline
+void writeProfiles(const std::vector<std::unique_ptr<Profile>>& profiles, const std::string& outputCSV){
+    // Instances the task skipped or that failed before their first phase recorded nothing
+    std::vector<const Profile*> finished;
+    for (const auto& profile : profiles) {
+        if (profile && !profile->spans().empty()) finished.push_back(profile.get());
+    }
+
+    std::string base = hasExtension(outputCSV, ".csv") ? outputCSV.substr(0, outputCSV.size() - 4) : outputCSV;
+    std::ofstream csv(base + "_profile.csv");
+    std::ofstream trace(base + "_trace.json");
+    if (!csv.is_open() || !trace.is_open()) {
+        throw std::runtime_error("Could not open profile output next to " + outputCSV);
+    }
+    writeProfileCSV(csv, finished);
+    writeProfileTrace(trace, finished);
+    std::cout << "Profile written: " << base << "_profile.csv, " << base << "_trace.json" << std::endl;
+}
+
+} // namespace
+
+std::vector<std::string> listInstances(const std::string& source){
+    std::vector<std::string> instances;
+
+    struct stat info;
+    if (stat(source.c_str(), &info) != 0) {
+        throw std::runtime_error("Could not open instance source: " + source);
+    }
+
+    if (S_ISDIR(info.st_mode)) {
+        DIR* dir = opendir(source.c_str());
+        if (!dir) {
+            throw std::runtime_error("Could not open directory: " + source);
+        }
+
+        struct dirent* entry;
+        while ((entry = readdir(dir)) != nullptr) {
+            std::string filename = entry->d_name;
+            if (hasExtension(filename, ".gr") || hasExtension(filename, ".hgr")) {
+                instances.push_back(source + "/" + filename);
+            }
+        }
+        closedir(dir);
+
+        std::sort(instances.begin(), instances.end());
+    } else {
+        std::ifstream list(source);
+        std::string line;
+        while (std::getline(list, line)) {
+            line.erase(line.find_last_not_of(" \t\r") + 1);
+            if (line.empty() || line[0] == '#') continue;
+            instances.push_back(line);
+        }
+    }
+
+    return instances;
+}
+
+void runBatch(const std::vector<std::string>& instances, const std::string& task, const std::string& outputCSV, const BatchOptions& options){
+    bool solverTask = task != "properties" && task != "reductions";
+    if (solverTask && !isSolver(task)) {
+        throw std::runtime_error("Unsupported batch task: " + task);
+    }
+    if (task == "ilp_check") {
+        throw std::runtime_error("ilp_check needs a bound k per instance and is not supported in batch mode");
+    }
+
+    std::ofstream csvFile(outputCSV);
+    if (!csvFile.is_open()) {
+        throw std::runtime_error("Could not open output CSV file: " + outputCSV);
+    }
+
+    // Write CSV header
+    csvFile << csvHeader(task) << std::endl;
+
+    std::mutex csvMutex;
+    ThreadPool pool(options.jobs);
+    std::vector<std::unique_ptr<Profile>> profiles(instances.size());
+
+    for (size_t i = 0; i < instances.size(); ++i) {
+        const std::string& path = instances[i];
+        if (options.profile) profiles[i] = std::make_unique<Profile>(baseName(path));
+
+        pool.submit([&, i, path]() {
+            ProfileScope scope(profiles[i].get());
+            std::string row;
+            try {
+                if (task == "properties") row = propertiesRow(path, options.propertyThreads);
+                else if (task == "reductions") row = reductionsRow(path);
+                else row = solverRow(path, task, options);
+            } catch (const std::exception& e) {
+                std::lock_guard<std::mutex> lock(csvMutex);
+                std::cerr << path << ": " << e.what() << std::endl;
+                return;
+            }
+
+            // Flush every row so finished instances survive an aborted sweep
+            std::lock_guard<std::mutex> lock(csvMutex);
+            csvFile << row << std::endl;
+            std::cout << baseName(path) << std::endl;
+        });
+    }
+    pool.wait();
+
+    csvFile.close();
+    std::cout << "CSV file generated: " << outputCSV << std::endl;
+
+    if (options.profile) writeProfiles(profiles, outputCSV);
+}
+
+void generateCSVForGraphs(const std::string& folderPath, const std::string& outputCSV) {
+    // Instances one after another, each on all threads, so a few huge graphs do not serialize the end
+    BatchOptions options;
+    options.jobs = 1;
+    options.propertyThreads = 0;
+    runBatch(listInstances(folderPath), "properties", outputCSV, options);
+}
+
+void generateReductionCSV(const std::string& folderPath, const std::string& outputCSV) {
+    runBatch(listInstances(folderPath), "reductions", outputCSV, BatchOptions());
+}
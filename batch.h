@@ -0,0 +1,30 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <string>
+#include <vector>
+
+#include "solvers.h"
+
+struct BatchOptions {
+    int jobs = 0;               // Instances processed concurrently, 0 uses all hardware threads
+    bool reduce = false;        // Reduce exhaustively before handing the kernel to a solver
+    bool relaxation = false;    // After reducing, fix variables by LP reduced costs and pass its bound on
+    std::string kernelDir;      // Snapshots of the kernels are kept here and reused by later runs, empty disables
+    int propertyThreads = 1;    // Threads computing the properties of one instance, 0 uses all hardware threads
+    bool profile = false;       // Time phases and reduction rules, written next to the CSV as <task>_profile.csv and <task>_trace.json
+    SolverOptions solver;
+};
+
+// A directory yields its *.gr and *.hgr files sorted by name, any other file is read as
+// a list with one instance path per line
+std::vector<std::string> listInstances(const std::string& source);
+
+// Runs task ("properties", "reductions" or a solver name) on every instance and streams one
+// CSV row per instance into outputCSV as soon as it is finished, so rows come in completion order
+void runBatch(const std::vector<std::string>& instances, const std::string& task, const std::string& outputCSV, const BatchOptions& options);
+
+void generateCSVForGraphs(const std::string& folderPath, const std::string& outputCSV);
+void generateReductionCSV(const std::string& folderPath, const std::string& outputCSV);
+
+#endif // BATCH_H
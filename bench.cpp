@@ -0,0 +1,285 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <set>
+#include <cmath>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <stdexcept>
+
+#include "graph.h"
+#include "hypergraph2.h"
+#include "parser.h"
+#include "generators.h"
+#include "subprocess.h"
+
+// Microbenchmarks of the parsers, the reduction rules, the graph statistics and the model writers
+// on generated graphs. Every benchmark repeats until it has run for the minimum time and reports
+// the median iteration, so runs before and after a change can be compared row by row.
+
+namespace {
+
+// Keeps the compiler from dropping results nobody looks at
+volatile long long sink = 0;
+
+// Swallows whatever the writers produce
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override {return c;}
+    std::streamsize xsputn(const char*, std::streamsize count) override {return count;}
+};
+
+struct Instance {
+    std::string name;           // family/size
+    EdgeList edges;
+    Graph graph;
+    Hypergraph hypergraph;
+    std::string file;           // The graph as .gr, for the parsers
+};
+
+struct Measurement {
+    std::string name;
+    long long edges = 0;
+    int iterations = 0;
+    double median = 0;          // Seconds per iteration
+    double fastest = 0;
+};
+
+struct Settings {
+    std::vector<std::string> sizes = {"small", "medium"};
+    std::string filter;
+    double minTime = 0.5;
+    std::string csvFile;
+};
+
+// An iteration does its own setup and returns the seconds of the part that is measured
+using Iteration = std::function<double()>;
+
+template <typename Body>
+double timed(Body&& body){
+    auto start = std::chrono::steady_clock::now();
+    body();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+Measurement run(const std::string& name, long long edges, const Iteration& iteration, const Settings& settings){
+    iteration(); // Warm caches and lazily built state
+
+    std::vector<double> times;
+    double total = 0;
+    while ((total < settings.minTime || times.size() < 3) && times.size() < 1000) {
+        times.push_back(iteration());
+        total += times.back();
+        if (total >= settings.minTime && times.back() >= settings.minTime) break; // One slow iteration is enough
+    }
+    std::sort(times.begin(), times.end());
+
+    Measurement measurement;
+    measurement.name = name;
+    measurement.edges = edges;
+    measurement.iterations = times.size();
+    measurement.median = times[times.size() / 2];
+    measurement.fastest = times.front();
+    return measurement;
+}
+
+std::string humanTime(double seconds){
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(2);
+    if (seconds >= 1) text << seconds << " s";
+    else if (seconds >= 1e-3) text << seconds * 1e3 << " ms";
+    else text << seconds * 1e6 << " us";
+    return text.str();
+}
+
+std::string humanRate(double rate){
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(2);
+    if (rate >= 1e9) text << rate / 1e9 << "G/s";
+    else if (rate >= 1e6) text << rate / 1e6 << "M/s";
+    else if (rate >= 1e3) text << rate / 1e3 << "k/s";
+    else text << rate << "/s";
+    return text.str();
+}
+
+// Target edge counts of the sizes; every family is scaled to land close to them
+long long targetEdges(const std::string& size){
+    if (size == "small") return 10000;
+    if (size == "medium") return 100000;
+    if (size == "large") return 1000000;
+    throw std::runtime_error("Unknown size: " + size + " (small, medium or large)");
+}
+
+Instance makeInstance(const std::string& family, const std::string& size, const TempDir& temp){
+    long long target = targetEdges(size);
+    EdgeList edges;
+    if (family == "grid") {
+        int side = std::max(2, static_cast<int>(std::sqrt(target / 2.0)));
+        edges = gridGraph(side, side);
+    } else if (family == "powerlaw") {
+        edges = barabasiAlbertGraph(target / 4, 4, 1);
+    } else {
+        // Average degree 8: n^2 * pi * r^2 / 2 edges are expected
+        int n = target / 4;
+        edges = randomGeometricGraph(n, std::sqrt(2.0 * target / (M_PI * n * static_cast<double>(n))), 1);
+    }
+
+    std::string file = temp.file(family + "_" + size + ".gr");
+    std::ofstream out(file);
+    writeGraph(edges, out);
+    out.close();
+
+    Graph graph = buildGraph(edges);
+    Hypergraph hypergraph = buildHypergraph(edges);
+    return Instance{family + "/" + size, std::move(edges), std::move(graph), std::move(hypergraph), file};
+}
+
+using Reduction = int (Hypergraph::*)(std::set<int>&, bool);
+
+void benchmarkInstance(const Instance& instance, const Settings& settings, std::vector<Measurement>& results){
+    long long m = instance.edges.edges.size();
+    NullBuffer discard;
+    std::ostream null(&discard);
+
+    std::vector<std::pair<std::string, Iteration>> benchmarks;
+
+    benchmarks.push_back({"parse/graph", [&]() {
+        return timed([&]() {sink += readGraphFromFile(instance.file).getEdges();});
+    }});
+    benchmarks.push_back({"parse/hypergraph", [&]() {
+        return timed([&]() {sink += readHypergraphFromFile(instance.file).numHyperedges();});
+    }});
+
+    std::vector<std::pair<std::string, Reduction>> reductions = {
+        {"isolated_vertex", &Hypergraph::reductionIsolatedVertex},
+        {"single_edge_vertex", &Hypergraph::reductionSingleEdgeVertex},
+        {"dominating_edge", &Hypergraph::reductionDominatingEdge},
+        {"dominating_vertex", &Hypergraph::reductionDominatingVertex},
+        {"counting_rule", &Hypergraph::reductionCountingRule},
+    };
+    for (const auto& [name, reduction] : reductions) {
+        benchmarks.push_back({"reduce/" + name, [&, reduction = reduction]() {
+            Hypergraph hypergraph = instance.hypergraph;
+            std::set<int> dominatingSet;
+            return timed([&]() {sink += (hypergraph.*reduction)(dominatingSet, false);});
+        }});
+    }
+    benchmarks.push_back({"reduce/exhaustively", [&]() {
+        Hypergraph hypergraph = instance.hypergraph;
+        std::set<int> dominatingSet;
+        return timed([&]() {sink += hypergraph.reduceExhaustively(dominatingSet, false).countingRule;});
+    }});
+
+    benchmarks.push_back({"graph/greedy_dominating_set", [&]() {
+        Graph graph = instance.graph;
+        return timed([&]() {sink += graph.greedyDominatingSet().size();});
+    }});
+    benchmarks.push_back({"graph/count_triangles", [&]() {
+        return timed([&]() {sink += instance.graph.countTriangles();});
+    }});
+    benchmarks.push_back({"graph/efficiency_lower_bound", [&]() {
+        Graph graph = instance.graph;
+        return timed([&]() {sink += graph.computeEfficiencyLowerBound();});
+    }});
+
+    // Writers without a stream overload go to /dev/null, so only formatting and the write calls count
+    benchmarks.push_back({"write/hypergraph_lp", [&]() {
+        return timed([&]() {instance.hypergraph.writeHittingSetLP(null, true);});
+    }});
+    benchmarks.push_back({"write/hypergraph_sat", [&]() {
+        return timed([&]() {instance.hypergraph.hypergraphToSAT(null);});
+    }});
+    benchmarks.push_back({"write/hypergraph_maxsat", [&]() {
+        return timed([&]() {instance.hypergraph.writeMaxSAT(null);});
+    }});
+    benchmarks.push_back({"write/graph_hgr", [&]() {
+        return timed([&]() {instance.graph.graphToHypergraph(null);});
+    }});
+    benchmarks.push_back({"write/graph_sat", [&]() {
+        return timed([&]() {instance.graph.graphToSAT("/dev/null");});
+    }});
+    benchmarks.push_back({"write/graph_ilp", [&]() {
+        return timed([&]() {instance.graph.writeHittingSetILP("/dev/null");});
+    }});
+    benchmarks.push_back({"write/graph_lp", [&]() {
+        return timed([&]() {instance.graph.writeHittingSetLP("/dev/null");});
+    }});
+    benchmarks.push_back({"write/graph_ilp_check", [&]() {
+        return timed([&]() {instance.graph.writeHittingSetILP_check(null, 1);});
+    }});
+
+    for (const auto& [name, iteration] : benchmarks) {
+        std::string fullName = name + "/" + instance.name;
+        if (fullName.find(settings.filter) == std::string::npos) continue;
+
+        Measurement measurement = run(fullName, m, iteration, settings);
+        std::cout << std::left << std::setw(56) << measurement.name << std::right
+                  << std::setw(12) << humanTime(measurement.median)
+                  << std::setw(12) << measurement.iterations
+                  << std::setw(14) << humanRate(m / measurement.median) << std::endl;
+        results.push_back(measurement);
+    }
+}
+
+void writeCSV(const std::string& filename, const std::vector<Measurement>& results){
+    std::ofstream csv(filename);
+    if (!csv.is_open()) {
+        throw std::runtime_error("Could not open output CSV file: " + filename);
+    }
+    csv << "Name,Edges,Iterations,Median (s),Fastest (s),Edges/s\n";
+    for (const auto& result : results) {
+        csv << result.name << "," << result.edges << "," << result.iterations << ","
+            << result.median << "," << result.fastest << "," << result.edges / result.median << "\n";
+    }
+}
+
+std::vector<std::string> splitList(const std::string& list){
+    std::vector<std::string> parts;
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) parts.push_back(item);
+    }
+    return parts;
+}
+
+} // namespace
+
+// ./bench [--filter TEXT] [--sizes small,medium,large] [--min-time S] [--csv FILE]
+int main(int argc, char* argv[]){
+    Settings settings;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--filter" && hasValue) settings.filter = argv[++i];
+        else if (arg == "--sizes" && hasValue) settings.sizes = splitList(argv[++i]);
+        else if (arg == "--min-time" && hasValue) settings.minTime = std::stod(argv[++i]);
+        else if (arg == "--csv" && hasValue) settings.csvFile = argv[++i];
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--filter TEXT] [--sizes small,medium,large] [--min-time S] [--csv FILE]" << std::endl;
+            return 1;
+        }
+    }
+
+    try {
+        TempDir temp;
+        std::vector<Measurement> results;
+        std::cout << std::left << std::setw(56) << "Benchmark" << std::right
+                  << std::setw(12) << "Time" << std::setw(12) << "Iterations" << std::setw(14) << "Edges/s" << std::endl;
+        for (const auto& size : settings.sizes) {
+            for (const std::string family : {"grid", "powerlaw", "geometric"}) {
+                Instance instance = makeInstance(family, size, temp);
+                benchmarkInstance(instance, settings, results);
+            }
+        }
+        if (!settings.csvFile.empty()) writeCSV(settings.csvFile, results);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
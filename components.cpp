@@ -0,0 +1,106 @@
+#include "components.h"
+
+#include <sstream>
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+#include "thread_pool.h"
+#include "localsearch.h"
+
+namespace {
+
+const int smallComponentSize = 20;
+
+// Components this small are solved optimally by the exact solver in no time, whatever the
+// solver. Only the LP relaxation runs itself, an integral optimum is not its value
+bool solvedExactly(const std::string& solver, int vertices){
+    return solver != "lp" && vertices <= smallComponentSize;
+}
+
+// Seconds shared by all components, 0 lets every component run to its own end
+double timeBudget(const std::string& solver, const SolverOptions& options){
+    if (options.timeLimit > 0) return options.timeLimit;
+    return solver == "localsearch" ? LocalSearchOptions().timeLimit : 0;
+}
+
+// Components that start after the budget is spent still get a moment to report a solution
+const double minimumComponentTime = 0.01;
+
+} // namespace
+
+SolverResult solveComponents(const std::string& solver, const std::string& graphFile, const Hypergraph& kernel, const SolverOptions& options){
+    if (solver == "findminhs" || solver == "ilp_check") {
+        throw std::runtime_error(solver + " works on the whole graph and cannot be run per component");
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto [parts, vertexMaps] = kernel.splitComponents();
+
+    SolverOptions partOptions = options;
+    partOptions.components = false;
+    partOptions.lowerBound = 0; // Holds for the whole kernel only
+
+    std::vector<SolverResult> results(parts.size());
+    ThreadPool pool(options.threads);
+
+    // Largest first, so a big component does not start last and hold up the rest
+    std::vector<int> order(parts.size());
+    for (size_t c = 0; c < parts.size(); ++c) order[c] = c;
+    std::sort(order.begin(), order.end(), [&](int a, int b) {
+        return vertexMaps[a].size() > vertexMaps[b].size();
+    });
+
+    // Every component gets a share of the budget in proportion to its size, as if all workers
+    // were busy until the deadline, but never beyond the deadline itself
+    double budget = timeBudget(solver, options);
+    double totalSize = 0;
+    for (const auto& map : vertexMaps) totalSize += map.size();
+    auto elapsed = [&]() {return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();};
+
+    std::vector<double> startedAt(parts.size(), 0);
+    for (int c : order) {
+        pool.submit([&, c]() {
+            SolverOptions componentOptions = partOptions;
+            startedAt[c] = elapsed();
+            if (budget > 0) {
+                double share = budget * pool.size() * vertexMaps[c].size() / totalSize;
+                componentOptions.timeLimit = std::max(minimumComponentTime, std::min(share, budget - startedAt[c]));
+            }
+            bool small = solvedExactly(solver, vertexMaps[c].size());
+            results[c] = runSolver(small ? "exact" : solver, graphFile, parts[c], componentOptions);
+        });
+    }
+    pool.wait();
+
+    // Merge back through the vertex maps
+    SolverResult result;
+    result.solutionSize = 0;
+    result.time = 0;
+    bool haveSolutions = true;
+    std::ostringstream output;
+    for (size_t c = 0; c < parts.size(); ++c) {
+        const auto& part = results[c];
+        output << "c " << c << " " << parts[c].numVertices() << " " << parts[c].numHyperedges() << " " << part.solutionSize << "\n";
+        if (options.verbose) output << part.output;
+
+        if (part.solutionSize < 0) result.solutionSize = -1;
+        else if (result.solutionSize >= 0) result.solutionSize += part.solutionSize;
+
+        // The merged solution is complete once the last component found its own, solvers that
+        // report no time count from when they finished
+        double found = part.time >= 0 ? part.time : part.wallTime;
+        result.time = std::max(result.time, startedAt[c] + found);
+
+        result.timedOut = result.timedOut || part.timedOut;
+        haveSolutions = haveSolutions && (int) part.solution.size() == part.solutionSize;
+        for (int v : part.solution) result.solution.push_back(vertexMaps[c][v]);
+    }
+    if (!haveSolutions) result.solution.clear();
+    std::sort(result.solution.begin(), result.solution.end());
+
+    if (result.solutionSize >= 0) output << "o " << result.solutionSize << " " << result.time << "\n";
+    result.output = output.str();
+    result.wallTime = elapsed();
+    return result;
+}
@@ -0,0 +1,20 @@
+#ifndef COMPONENTS_H
+#define COMPONENTS_H
+
+#include <string>
+
+#include "hypergraph2.h"
+#include "solvers.h"
+
+// Splits the active part of the kernel into connected components and solves them
+// independently on options.threads worker threads. Components of at most
+// smallComponentSize vertices are solved in-process by the exact solver unless solver is the
+// LP relaxation, everything else by solver.
+// The solution size is the sum over all components, -1 if one of them reported none; the
+// merged solution is only filled if every component returned its vertices. Its time is when
+// the last component found its solution.
+// The time limit (the default cutoff for localsearch) is shared: components get slices in
+// proportion to their size, so the whole call ends about when a single run would.
+SolverResult solveComponents(const std::string& solver, const std::string& graphFile, const Hypergraph& kernel, const SolverOptions& options);
+
+#endif // COMPONENTS_H
@@ -0,0 +1,118 @@
+#ifndef CSR_H
+#define CSR_H
+
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <cassert>
+
+// Contiguous view of a single CSR row
+template <typename T>
+struct RowView {
+    T* first;
+    T* last;
+
+    T* begin() const {return first;};
+    T* end() const {return last;};
+    std::size_t size() const {return last - first;};
+    bool empty() const {return first == last;};
+    T& operator[](std::size_t i) const {return first[i];};
+};
+
+// Compressed sparse row storage: row i occupies indices[offsets[i]] up to indices[offsets[i+1]].
+// Built in two passes: setRowSizes() with the counted row sizes, then append() every entry.
+// While building, offsets[row+1] doubles as the write cursor of row, so once every row
+// has received exactly its announced number of entries the offsets are final again.
+class CSR {
+private:
+    std::vector<std::size_t> offsets;
+    std::vector<int> indices;
+
+public:
+    CSR() : offsets(1, 0) {}
+    explicit CSR(int rows) : offsets(rows + 1, 0) {}
+
+    void setRowSizes(const std::vector<int>& sizes){
+        offsets.assign(sizes.size() + 1, 0);
+        std::size_t total = 0;
+        for (std::size_t i = 0; i < sizes.size(); ++i) {
+            offsets[i + 1] = total; // Cursor of row i starts at the beginning of row i
+            total += sizes[i];
+        }
+        indices.assign(total, 0);
+    }
+
+    // Returns the position of the new entry in the index array
+    std::size_t append(int row, int value){
+        assert(offsets[row + 1] < indices.size());
+        std::size_t position = offsets[row + 1]++;
+        indices[position] = value;
+        return position;
+    }
+
+    void assign(const std::vector<std::vector<int>>& rows){
+        std::vector<int> sizes(rows.size());
+        for (std::size_t i = 0; i < rows.size(); ++i) sizes[i] = rows[i].size();
+        setRowSizes(sizes);
+        for (std::size_t i = 0; i < rows.size(); ++i) {
+            for (int value : rows[i]) append(i, value);
+        }
+    }
+
+    // Column view of this matrix; rows of the result come out sorted
+    CSR transpose(int columns) const{
+        std::vector<int> sizes(columns, 0);
+        for (int value : indices) sizes[value]++;
+
+        CSR result;
+        result.setRowSizes(sizes);
+        for (std::size_t row = 0; row + 1 < offsets.size(); ++row) {
+            for (std::size_t k = offsets[row]; k < offsets[row + 1]; ++k) {
+                result.append(indices[k], row);
+            }
+        }
+        return result;
+    }
+
+    // Sorts every row and drops repeated entries, compacting the index array
+    void sortRows(){
+        std::size_t write = 0;
+        std::size_t begin = offsets[0];
+        for (std::size_t row = 0; row + 1 < offsets.size(); ++row) {
+            std::size_t end = offsets[row + 1];
+            std::sort(indices.begin() + begin, indices.begin() + end);
+            auto last = std::unique(indices.begin() + begin, indices.begin() + end);
+            for (auto it = indices.begin() + begin; it != last; ++it) {
+                indices[write++] = *it;
+            }
+            offsets[row + 1] = write;
+            begin = end;
+        }
+        indices.resize(write);
+    }
+
+    std::size_t size() const {return offsets.size() - 1;};
+    std::size_t entries() const {return indices.size();};
+    int degree(std::size_t row) const {return offsets[row + 1] - offsets[row];};
+
+    // Entries by their position in the index array, row i starts at rowBegin(i)
+    std::size_t rowBegin(std::size_t row) const {return offsets[row];};
+    int& entry(std::size_t position) {return indices[position];};
+
+    // Whole arrays, for writing and reading snapshots
+    const std::vector<std::size_t>& rawOffsets() const {return offsets;};
+    const std::vector<int>& rawIndices() const {return indices;};
+    void assignRaw(const std::size_t* rowOffsets, std::size_t rows, const int* values){
+        offsets.assign(rowOffsets, rowOffsets + rows + 1);
+        indices.assign(values, values + offsets[rows]);
+    }
+
+    RowView<const int> operator[](std::size_t row) const {
+        return {indices.data() + offsets[row], indices.data() + offsets[row + 1]};
+    };
+    RowView<int> operator[](std::size_t row) {
+        return {indices.data() + offsets[row], indices.data() + offsets[row + 1]};
+    };
+};
+
+#endif // CSR_H
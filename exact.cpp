@@ -0,0 +1,179 @@
+#include "exact.h"
+
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+BranchAndReduce::BranchAndReduce(Hypergraph& hypergraph, const ExactOptions& options) : hypergraph(hypergraph), options(options) {}
+
+ExactResult BranchAndReduce::solve(){
+    start = std::chrono::steady_clock::now();
+
+    std::set<int> forced;
+    hypergraph.reduceExhaustively(forced, false);
+    if (hypergraph.hasConflict()) {
+        throw std::runtime_error("Instance has a hyperedge that no vertex can cover");
+    }
+    partial.assign(forced.begin(), forced.end());
+
+    greedyUpperBound();
+    int rootBound = std::max<int>(partial.size() + lowerBound(), options.knownLowerBound);
+    if (options.verbose) {
+        std::cout << "Root: " << partial.size() << " forced, bounds " << rootBound << " - " << best.size() << std::endl;
+    }
+
+    if (options.onLowerBound) options.onLowerBound(rootBound);
+
+    size_t root = hypergraph.checkpoint();
+    search();
+    hypergraph.restoreCheckpoint(root);
+    hypergraph.releaseTrail();
+    partial.clear();
+
+    // A finished search rules out everything below the bound it pruned with
+    ExactResult result;
+    result.solution = best;
+    std::sort(result.solution.begin(), result.solution.end());
+    result.lowerBound = timedOut ? std::min<int>(rootBound, best.size()) : upperBound();
+    result.optimal = !timedOut && result.lowerBound == static_cast<int>(best.size());
+    if (!timedOut && options.onLowerBound) options.onLowerBound(result.lowerBound);
+    result.nodes = nodes;
+    result.time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+void BranchAndReduce::greedyUpperBound(){
+    best = partial;
+    auto greedy = hypergraph.greedyHittingSet();
+    best.insert(best.end(), greedy.begin(), greedy.end());
+    bestKnown = true;
+    if (options.onImprovement) options.onImprovement(best);
+}
+
+// Own incumbent or a smaller one found elsewhere, whichever is better
+int BranchAndReduce::upperBound() const{
+    int bound = best.size();
+    if (options.sharedUpperBound) bound = std::min(bound, options.sharedUpperBound->load());
+    return bound;
+}
+
+// Every active hyperedge needs a vertex, and a vertex covers at most its live degree of them
+double BranchAndReduce::efficiencyBound() const{
+    double bound = 0.0;
+    for (int e = 0; e < hypergraph.numHyperedges(); ++e) {
+        if (!hypergraph.isActive(e)) continue;
+
+        int maxDeg = 1;
+        for (int v : hypergraph.verticesOf(e)) {
+            if (hypergraph.isUsable(v)) maxDeg = std::max(maxDeg, hypergraph.getLiveDegree(v));
+        }
+        bound += 1.0 / maxDeg;
+    }
+    return bound;
+}
+
+// Active hyperedges without a common usable vertex need distinct vertices; small ones are packed first
+int BranchAndReduce::packingBound(){
+    if (packed.size() != static_cast<size_t>(hypergraph.numVertices())) {
+        packed.assign(hypergraph.numVertices(), 0);
+        stamp = 0;
+    }
+    stamp++;
+
+    std::vector<int> order;
+    for (int e = 0; e < hypergraph.numHyperedges(); ++e) {
+        if (hypergraph.isActive(e)) order.push_back(e);
+    }
+    std::sort(order.begin(), order.end(), [&](int a, int b) {
+        return hypergraph.getLiveSize(a) < hypergraph.getLiveSize(b);
+    });
+
+    int bound = 0;
+    for (int e : order) {
+        bool disjoint = true;
+        for (int v : hypergraph.verticesOf(e)) {
+            if (hypergraph.isUsable(v) && packed[v] == stamp) {
+                disjoint = false;
+                break;
+            }
+        }
+        if (!disjoint) continue;
+
+        for (int v : hypergraph.verticesOf(e)) {
+            if (hypergraph.isUsable(v)) packed[v] = stamp;
+        }
+        bound++;
+    }
+    return bound;
+}
+
+int BranchAndReduce::lowerBound(){
+    int efficiency = static_cast<int>(std::ceil(efficiencyBound() - 1e-9));
+    return std::max(efficiency, packingBound());
+}
+
+// A usable vertex of highest live degree in the smallest active hyperedge, -1 if everything is covered
+int BranchAndReduce::chooseBranchVertex() const{
+    int smallest = -1;
+    for (int e = 0; e < hypergraph.numHyperedges(); ++e) {
+        if (!hypergraph.isActive(e)) continue;
+        if (smallest == -1 || hypergraph.getLiveSize(e) < hypergraph.getLiveSize(smallest)) smallest = e;
+    }
+    if (smallest == -1) return -1;
+
+    int vertex = -1;
+    for (int v : hypergraph.verticesOf(smallest)) {
+        if (!hypergraph.isUsable(v)) continue;
+        if (vertex == -1 || hypergraph.getLiveDegree(v) > hypergraph.getLiveDegree(vertex)) vertex = v;
+    }
+    return vertex;
+}
+
+void BranchAndReduce::propagateAndRecord(){
+    std::set<int> chosen;
+    hypergraph.propagate(chosen, false);
+    partial.insert(partial.end(), chosen.begin(), chosen.end());
+}
+
+void BranchAndReduce::search(){
+    nodes++;
+    if (options.timeLimit > 0 && std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() > options.timeLimit) {
+        timedOut = true;
+    }
+    if (options.stop && *options.stop) timedOut = true;
+    if (timedOut || hypergraph.hasConflict()) return;
+    if (bestKnown && upperBound() <= options.knownLowerBound) return;
+
+    if (bestKnown && static_cast<int>(partial.size()) + lowerBound() >= upperBound()) return;
+
+    int v = chooseBranchVertex();
+    if (v == -1) {
+        // Everything is covered, and the bound check above made sure this is an improvement
+        best = partial;
+        bestKnown = true;
+        if (options.verbose) std::cout << "Exact: improved to " << best.size() << " after " << nodes << " nodes" << std::endl;
+        if (options.onImprovement) options.onImprovement(best);
+        return;
+    }
+
+    size_t mark = hypergraph.checkpoint();
+    size_t depth = partial.size();
+
+    // Take v
+    std::set<int> chosen;
+    hypergraph.selectVertex(v, chosen);
+    partial.insert(partial.end(), chosen.begin(), chosen.end());
+    propagateAndRecord();
+    search();
+
+    partial.resize(depth);
+    hypergraph.restoreCheckpoint(mark);
+
+    // Leave v out, the smallest hyperedge then has to be covered by one of its other vertices
+    hypergraph.excludeVertex(v);
+    propagateAndRecord();
+    search();
+
+    partial.resize(depth);
+}
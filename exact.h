@@ -0,0 +1,67 @@
+#ifndef EXACT_H
+#define EXACT_H
+
+#include <vector>
+#include <set>
+#include <chrono>
+#include <atomic>
+#include <functional>
+
+#include "hypergraph2.h"
+
+struct ExactOptions {
+    double timeLimit = 0;       // Seconds, 0 means unlimited
+    int knownLowerBound = 0;    // Proven elsewhere, e.g. by the LP stage; a solution of this size ends the search
+    bool verbose = false;
+
+    // Hooks for running next to other solvers, all optional
+    const std::atomic<bool>* stop = nullptr;            // Ends the search like the time limit
+    const std::atomic<int>* sharedUpperBound = nullptr; // Size of the best solution found elsewhere, prunes as well
+    std::function<void(const std::vector<int>&)> onImprovement;
+    std::function<void(int)> onLowerBound;
+};
+
+struct ExactResult {
+    std::vector<int> solution;  // Sorted, 0-based; covers every hyperedge active at the start
+    bool optimal = false;       // false if the search was stopped or a shared solution was smaller
+    int lowerBound = 0;         // Proven lower bound, the root bound if the search was stopped
+    long long nodes = 0;
+    double time = 0;
+};
+
+// Exact hitting set solver on the active part of a Hypergraph. Every node applies the
+// reduction rules to what the last decision touched, is pruned by the efficiency and packing
+// lower bounds, and otherwise branches on a vertex of the smallest active hyperedge:
+// first taking it, then excluding it.
+class BranchAndReduce {
+private:
+    Hypergraph& hypergraph;
+    ExactOptions options;
+
+    std::vector<int> partial;   // Vertices chosen on the path to the current node
+    std::vector<int> best;
+    bool bestKnown = false;
+    bool timedOut = false;
+    long long nodes = 0;
+    std::chrono::steady_clock::time_point start;
+
+    std::vector<unsigned> packed; // Packing bound scratch, entries equal to stamp are taken
+    unsigned stamp = 0;
+
+    void greedyUpperBound();
+    int upperBound() const;
+    double efficiencyBound() const;
+    int packingBound();
+    int lowerBound();
+    int chooseBranchVertex() const;
+    void propagateAndRecord();
+    void search();
+
+public:
+    explicit BranchAndReduce(Hypergraph& hypergraph, const ExactOptions& options = ExactOptions());
+
+    // Leaves the hypergraph in its reduced root state
+    ExactResult solve();
+};
+
+#endif // EXACT_H
@@ -0,0 +1,236 @@
+#include "generators.h"
+
+#include <random>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+#include "writer.h"
+
+EdgeList erdosRenyiGraph(int vertices, double degree, unsigned seed){
+    if (vertices < 1 || degree < 0) {
+        throw std::runtime_error("Random graph needs at least one vertex and a non-negative degree");
+    }
+
+    EdgeList graph;
+    graph.vertices = vertices;
+    double p = vertices > 1 ? std::min(1.0, degree / (vertices - 1)) : 0.0;
+    if (p <= 0) return graph;
+    graph.edges.reserve(static_cast<std::size_t>(degree * vertices / 2 * 1.05));
+
+    // Walks the pairs (v, w) with w < v in order, jumping a geometrically distributed number ahead
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    double logQ = p < 1 ? std::log(1.0 - p) : 0.0;
+    long long v = 1, w = -1;
+    while (v < vertices) {
+        w += p < 1 ? 1 + static_cast<long long>(std::log(1.0 - uniform(rng)) / logQ) : 1;
+        while (w >= v && v < vertices) {
+            w -= v;
+            v++;
+        }
+        if (v < vertices) graph.edges.push_back({static_cast<int>(w), static_cast<int>(v)});
+    }
+    return graph;
+}
+
+EdgeList gridGraph(int rows, int cols){
+    if (rows < 1 || cols < 1) {
+        throw std::runtime_error("Grid needs at least one row and column");
+    }
+
+    EdgeList graph;
+    graph.vertices = rows * cols;
+    graph.edges.reserve(2 * static_cast<std::size_t>(graph.vertices));
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            int v = r * cols + c;
+            if (c + 1 < cols) graph.edges.push_back({v, v + 1});
+            if (r + 1 < rows) graph.edges.push_back({v, v + cols});
+        }
+    }
+    return graph;
+}
+
+EdgeList roadGraph(int rows, int cols, unsigned seed){
+    EdgeList streets = gridGraph(rows, cols);
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::uniform_int_distribution<int> segments(1, 3);
+
+    EdgeList graph;
+    graph.vertices = streets.vertices;
+    for (auto [u, v] : streets.edges) {
+        if (uniform(rng) >= 0.8) continue;
+
+        // Intermediate vertices get fresh ids after the intersections
+        int previous = u;
+        for (int s = segments(rng); s > 1; --s) {
+            int middle = graph.vertices++;
+            graph.edges.push_back({previous, middle});
+            previous = middle;
+        }
+        graph.edges.push_back({previous, v});
+    }
+    return graph;
+}
+
+EdgeList barabasiAlbertGraph(int vertices, int attach, unsigned seed){
+    if (vertices < 1 || attach < 1) {
+        throw std::runtime_error("Preferential attachment needs at least one vertex and one edge per vertex");
+    }
+
+    EdgeList graph;
+    graph.vertices = vertices;
+    std::mt19937 rng(seed);
+
+    // Every edge puts both endpoints here, so a uniform pick is a pick proportional to degree
+    std::vector<int> endpoints;
+    endpoints.reserve(2 * static_cast<std::size_t>(vertices) * attach);
+
+    // The first attach+1 vertices form a clique, so there are enough distinct targets from then on
+    int seedSize = std::min(vertices, attach + 1);
+    for (int u = 0; u < seedSize; ++u) {
+        for (int v = u + 1; v < seedSize; ++v) {
+            graph.edges.push_back({u, v});
+            endpoints.push_back(u);
+            endpoints.push_back(v);
+        }
+    }
+
+    std::vector<int> targets;
+    for (int v = seedSize; v < vertices; ++v) {
+        targets.clear();
+        while (static_cast<int>(targets.size()) < attach) {
+            int u = endpoints[std::uniform_int_distribution<std::size_t>(0, endpoints.size() - 1)(rng)];
+            if (std::find(targets.begin(), targets.end(), u) == targets.end()) targets.push_back(u);
+        }
+        for (int u : targets) {
+            graph.edges.push_back({u, v});
+            endpoints.push_back(u);
+            endpoints.push_back(v);
+        }
+    }
+    return graph;
+}
+
+EdgeList randomGeometricGraph(int vertices, double radius, unsigned seed){
+    if (vertices < 1 || radius <= 0) {
+        throw std::runtime_error("Random geometric graph needs at least one vertex and a positive radius");
+    }
+
+    EdgeList graph;
+    graph.vertices = vertices;
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> coordinate(0.0, 1.0);
+    std::vector<double> x(vertices), y(vertices);
+    for (int v = 0; v < vertices; ++v) {
+        x[v] = coordinate(rng);
+        y[v] = coordinate(rng);
+    }
+
+    // Bucket the points by cell in CSR form, neighbors can only be in the 3x3 cells around a point
+    // More cells than points would only cost memory
+    int cells = std::max(1, static_cast<int>(std::min(1.0 / radius, std::sqrt(static_cast<double>(vertices)) + 1)));
+    auto cellOf = [&](double value) {return std::min(cells - 1, static_cast<int>(value * cells));};
+    std::vector<int> cellSizes(static_cast<std::size_t>(cells) * cells, 0);
+    for (int v = 0; v < vertices; ++v) cellSizes[cellOf(y[v]) * cells + cellOf(x[v])]++;
+    CSR buckets;
+    buckets.setRowSizes(cellSizes);
+    for (int v = 0; v < vertices; ++v) buckets.append(cellOf(y[v]) * cells + cellOf(x[v]), v);
+
+    double squared = radius * radius;
+    for (int v = 0; v < vertices; ++v) {
+        int cx = cellOf(x[v]), cy = cellOf(y[v]);
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                int nx = cx + dx, ny = cy + dy;
+                if (nx < 0 || ny < 0 || nx >= cells || ny >= cells) continue;
+                for (int u : buckets[ny * cells + nx]) {
+                    if (u <= v) continue; // Every pair once
+                    double ex = x[u] - x[v], ey = y[u] - y[v];
+                    if (ex * ex + ey * ey <= squared) graph.edges.push_back({v, u});
+                }
+            }
+        }
+    }
+    return graph;
+}
+
+bool isGraphFamily(const std::string& family){
+    return family == "er" || family == "ba" || family == "geometric" || family == "grid" || family == "road";
+}
+
+EdgeList generateGraph(const std::string& family, int vertices, double degree, unsigned seed){
+    if (family == "er") return erdosRenyiGraph(vertices, degree, seed);
+    if (family == "ba") return barabasiAlbertGraph(vertices, std::max(1, static_cast<int>(std::lround(degree / 2))), seed);
+    if (family == "geometric") return randomGeometricGraph(vertices, std::sqrt(degree / (M_PI * vertices)), seed);
+
+    int side = std::max(1, static_cast<int>(std::lround(std::sqrt(vertices))));
+    if (family == "grid") return gridGraph(side, side);
+    if (family == "road") {
+        // Every intersection brings about 1.6 segment vertices on average
+        side = std::max(1, static_cast<int>(std::lround(std::sqrt(vertices / 2.6))));
+        return roadGraph(side, side, seed);
+    }
+    throw std::runtime_error("Unknown graph family: " + family);
+}
+
+Graph buildGraph(const EdgeList& edges){
+    std::vector<int> degrees(edges.vertices, 0);
+    for (auto [u, v] : edges.edges) {
+        degrees[u]++;
+        degrees[v]++;
+    }
+
+    Graph graph(edges.vertices);
+    graph.reserveNeighbors(degrees);
+    for (auto [u, v] : edges.edges) graph.addEdge(u + 1, v + 1); // addEdge takes the 1-based ids of the file format
+    return graph;
+}
+
+Hypergraph buildHypergraph(const EdgeList& edges){
+    int n = edges.vertices;
+    std::vector<int> sizes(n, 1); // Closed neighborhoods contain the vertex itself
+    for (auto [u, v] : edges.edges) {
+        sizes[u]++;
+        sizes[v]++;
+    }
+
+    Hypergraph hypergraph(n, n, n);
+    hypergraph.reserveHyperedges(sizes);
+    hypergraph.initEdge(n);
+    for (auto [u, v] : edges.edges) hypergraph.addEdge(u + 1, v + 1);
+    hypergraph.setVertexToHyperedges();
+    return hypergraph;
+}
+
+void writeGraph(const EdgeList& graph, std::ostream& stream){
+    TextWriter file(stream);
+    file << "p ds " << graph.vertices << ' ' << graph.edges.size() << '\n';
+    for (auto [u, v] : graph.edges) {
+        file << u + 1 << ' ' << v + 1 << '\n';
+    }
+}
+
+void writeNeighborhoodHypergraph(const EdgeList& graph, std::ostream& stream){
+    std::vector<int> degrees(graph.vertices, 0);
+    for (auto [u, v] : graph.edges) {
+        degrees[u]++;
+        degrees[v]++;
+    }
+    CSR neighbors;
+    neighbors.setRowSizes(degrees);
+    for (auto [u, v] : graph.edges) {
+        neighbors.append(u, v);
+        neighbors.append(v, u);
+    }
+
+    TextWriter file(stream);
+    file << "p hs " << graph.vertices << ' ' << graph.vertices << '\n';
+    for (int u = 0; u < graph.vertices; ++u) {
+        file << u + 1;
+        for (int v : neighbors[u]) file << ' ' << v + 1;
+        file << '\n';
+    }
+}
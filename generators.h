@@ -0,0 +1,52 @@
+#ifndef GENERATORS_H
+#define GENERATORS_H
+
+#include <vector>
+#include <string>
+#include <utility>
+#include <ostream>
+
+#include "graph.h"
+#include "hypergraph2.h"
+
+// Simple undirected graph on vertices 0 .. vertices-1, every edge listed once without loops
+struct EdgeList {
+    int vertices = 0;
+    std::vector<std::pair<int, int>> edges;
+};
+
+// G(n, p) with p chosen for the expected average degree, skipping over absent pairs
+// (Batagelj and Brandes), so the time is linear in the number of edges
+EdgeList erdosRenyiGraph(int vertices, double degree, unsigned seed);
+
+// rows x cols grid, every vertex joined to its right and lower neighbor
+EdgeList gridGraph(int rows, int cols);
+
+// Sparse grid of intersections: every street of the grid survives with probability 0.8 and is
+// split into one to three segments, which gives the many degree-two vertices of road networks
+EdgeList roadGraph(int rows, int cols, unsigned seed);
+
+// Preferential attachment: every new vertex joins attach distinct earlier vertices, picked with
+// probability proportional to their degree, which gives a power-law degree distribution
+EdgeList barabasiAlbertGraph(int vertices, int attach, unsigned seed);
+
+// Uniform points in the unit square, joined whenever they are at most radius apart.
+// Candidates come from a grid of radius-sized cells, so the expected time is linear
+EdgeList randomGeometricGraph(int vertices, double radius, unsigned seed);
+
+// Families by name: "er", "ba", "geometric", "grid" and "road". vertices is approximate for the
+// grid-based families, degree is the expected average degree and ignored by them
+EdgeList generateGraph(const std::string& family, int vertices, double degree, unsigned seed);
+bool isGraphFamily(const std::string& family);
+
+// The same structures readGraphFromFile and readHypergraphFromFile build from a .gr file
+Graph buildGraph(const EdgeList& graph);
+Hypergraph buildHypergraph(const EdgeList& graph);
+
+// PACE .gr format
+void writeGraph(const EdgeList& graph, std::ostream& stream);
+
+// Closed neighborhoods in the .hgr format of readHypergraphFromFile, one hyperedge per vertex
+void writeNeighborhoodHypergraph(const EdgeList& graph, std::ostream& stream);
+
+#endif // GENERATORS_H
@@ -1,63 +1,83 @@
 #include "graph.h"
 
-Graph::Graph(int vertices) : vertices(vertices), adj(vertices) {}
+#include <atomic>
+
+#include "writer.h"
+#include "thread_pool.h"
+
+namespace {
+
+// Vertices per task of the parallel property passes
+const int propertyBlock = 4096;
+
+} // namespace
+
+Graph::Graph(int vertices) : vertices(vertices), adj(vertices), neighbors(vertices) {}
+
+void Graph::reserveNeighbors(const std::vector<int>& degrees) {
+    neighbors.setRowSizes(degrees);
+    mirror.assign(neighbors.entries(), 0);
+}
 
 void Graph::addEdge(int u, int v) {
-    adj[u-1].edges.push_back(v-1); // Assuming 1-based index in the .gr file, converting to 0-based
-    adj[v-1].edges.push_back(u-1);  // Undirected graph, so add edge in both directions
+    std::size_t forward = neighbors.append(u-1, v-1); // Assuming 1-based index in the .gr file, converting to 0-based
+    std::size_t backward = neighbors.append(v-1, u-1);  // Undirected graph, so add edge in both directions
+    mirror[forward] = backward;
+    mirror[backward] = forward;
     edges += 1;
 }
 
+// Swaps two entries of the same row and points their reverse entries at the new positions
+void Graph::swapEntries(std::size_t a, std::size_t b) {
+    if (a == b) return;
+    std::swap(neighbors.entry(a), neighbors.entry(b));
+    std::swap(mirror[a], mirror[b]);
+    mirror[mirror[a]] = a;
+    mirror[mirror[b]] = b;
+}
+
+// Both directions only touch the entries of u and their reverse entries, so O(deg(u))
 void Graph::makeNodeInvisible(int u){
     assert(adj[u].active);
 
-    Node* node = &adj[u];
-
-    for (int i = 0; i < node->edges.size(); i++){
-        int v = node->edges[i];
+    std::size_t begin = neighbors.rowBegin(u);
+    for (int i = 0; i < neighbors.degree(u); i++) {
+        int v = neighbors[u][i];
         Node* neighbor = &adj[v];
 
-        //make node invisible in all adjacency lists of neighbours
-        assert(neighbor->edges.size() > neighbor->offset);
-        for (int j = neighbor->offset; j < neighbor->edges.size(); j++) {
-            if (neighbor->edges[j] != u) {
-                continue;
-            }
-            //add node to invisible nodes and add visible counter
-            std::swap(neighbor->edges[j], neighbor->edges[neighbor->offset]);
-            neighbor->offset++;
-        }
+        //make node invisible in the adjacency list of the neighbour by moving it to the end of the invisible part
+        std::size_t position = mirror[begin + i];
+        assert(position >= neighbors.rowBegin(v) + neighbor->offset);
+        swapEntries(position, neighbors.rowBegin(v) + neighbor->offset);
+        neighbor->offset++;
     }
 
-    node->active = false;
+    adj[u].active = false;
 }
 
 void Graph::makeNodeVisible(int u) {
     assert(!adj[u].active);
 
     Node* node = &adj[u];
+    std::size_t begin = neighbors.rowBegin(u);
     node->offset = 0;
     node->active = true;
 
-    for (int i = 0; i < node->edges.size(); i++) {
-        Node* neighbor = &adj[node->edges[i]];
+    for (int i = 0; i < neighbors.degree(u); i++) {
+        int v = neighbors[u][i];
+        Node* neighbor = &adj[v];
+        std::size_t position = mirror[begin + i];
 
         // Handle inactive neighbors
         if (!neighbor->active){
-            std::swap(node->edges[i], node->edges[node->offset]);
+            swapEntries(begin + i, begin + node->offset);
             node->offset++;
         }
 
-        //make node visible in all adjacency lists of neighbours
-        assert(neighbor->offset > 0);
-        for (int j = 0; j < neighbor->offset; j++) {
-            if (neighbor->edges[j] != u) {
-                continue;
-            }
-            //add node to visible nodes and reduce visible counter
-            std::swap(neighbor->edges[j], neighbor->edges[neighbor->offset - 1]);
-            neighbor->offset--;
-        }
+        //make node visible in the adjacency list of the neighbour by moving it to the end of the invisible part
+        assert(neighbor->offset > 0 && position < neighbors.rowBegin(v) + neighbor->offset);
+        swapEntries(position, neighbors.rowBegin(v) + neighbor->offset - 1);
+        neighbor->offset--;
     }
 }
 
@@ -74,13 +94,13 @@ void Graph::printGraph() const {
         }
 
         // Print the neighbors with a visual offset marker '|'
-        for (int j = 0; j < adj[i].edges.size(); ++j) {
+        for (int j = 0; j < neighbors[i].size(); ++j) {
             if (j == adj[i].offset) std::cout << "| ";  // Mark the offset position
-            std::cout << adj[i].edges[j]+1 << " ";
+            std::cout << neighbors[i][j]+1 << " ";
         }
 
         // If the offset equals the size of the neighborhood, place the '|'
-        if (adj[i].offset == adj[i].edges.size()) {
+        if (adj[i].offset == neighbors[i].size()) {
             std::cout << "|";
         }
 
@@ -91,7 +111,7 @@ void Graph::printGraph() const {
 int Graph::reductionIsolatedVertex(std::vector<int>& dominatingSet, bool verbose) {
     int occurence = 0;
     for (int i = 0; i < vertices; i++) {
-        if (adj[i].active && (adj[i].edges.size() == adj[i].offset)) {
+        if (adj[i].active && (neighbors[i].size() == adj[i].offset)) {
             dominatingSet.push_back(i);
             makeNodeInvisible(i);
             occurence++;
@@ -109,7 +129,7 @@ int Graph::reductionDominatingVertex(std::vector<int>& dominatingSet, bool verbo
     std::vector<std::pair<int, int>> degreeOrder;
     for (int u = 0; u < vertices; u++) {
         if (adj[u].active) {
-            degreeOrder.emplace_back(adj[u].edges.size(), u);
+            degreeOrder.emplace_back(neighbors[u].size(), u);
         }
     }
 
@@ -119,16 +139,16 @@ int Graph::reductionDominatingVertex(std::vector<int>& dominatingSet, bool verbo
     //for (int u = 0; u < vertices; u++) {
         if (!adj[u].active) continue;
 
-        for (int i = adj[u].offset; i < adj[u].edges.size(); i++) {
-            int v = adj[u].edges[i];
+        for (int i = adj[u].offset; i < neighbors[u].size(); i++) {
+            int v = neighbors[u][i];
             // u can only dominate v if it has more active edges left
-            if (adj[v].edges.size() > adj[u].edges.size()) continue;
+            if (neighbors[v].size() > neighbors[u].size()) continue;
 
             // Check if u dominates v's neighborhood
             bool dominates = true;
-            for (int j = 0; j < adj[v].edges.size(); j++) {
-                int neighbor = adj[v].edges[j];
-                if (neighbor != u && std::find(adj[u].edges.begin(), adj[u].edges.end(), neighbor) == adj[u].edges.end()) {
+            for (int j = 0; j < neighbors[v].size(); j++) {
+                int neighbor = neighbors[v][j];
+                if (neighbor != u && std::find(neighbors[u].begin(), neighbors[u].end(), neighbor) == neighbors[u].end()) {
                     dominates = false;
                     break;
                 }
@@ -151,9 +171,9 @@ int Graph::reductionDominatingVertex(std::vector<int>& dominatingSet, bool verbo
 int Graph::reductionSingleEdgeVertex(std::vector<int>& dominatingSet, bool verbose) {
     int occurence = 0;
     for (int i = 0; i < vertices; i++) {
-        if (!adj[i].active || adj[i].edges.size() != adj[i].offset + 1) continue;
+        if (!adj[i].active || neighbors[i].size() != adj[i].offset + 1) continue;
 
-        int neighbor = adj[i].edges[adj[i].offset];
+        int neighbor = neighbors[i][adj[i].offset];
         if (adj[neighbor].active) {
             // Add the neighbor to the dominating set
             dominatingSet.push_back(neighbor);
@@ -161,8 +181,8 @@ int Graph::reductionSingleEdgeVertex(std::vector<int>& dominatingSet, bool verbo
             // Remove the neighbor and initial node and mark all neighbors as covered
             makeNodeInvisible(neighbor);
             makeNodeInvisible(i);
-            for (int j = adj[neighbor].offset; j < adj[neighbor].edges.size(); j++) {
-                adj[adj[neighbor].edges[j]].covered = true;
+            for (int j = adj[neighbor].offset; j < neighbors[neighbor].size(); j++) {
+                adj[neighbors[neighbor][j]].covered = true;
             }
             occurence++;
         }
@@ -170,58 +190,65 @@ int Graph::reductionSingleEdgeVertex(std::vector<int>& dominatingSet, bool verbo
     return occurence;
 }
 
-std::vector<int> Graph::greedyDominatingSet() {
+std::vector<int> Graph::greedyDominatingSet() const{
     std::vector<int> dominatingSet;
     std::vector<bool> covered(vertices, false);  // To check if a vertex is covered
-    std::set<int> uncovered;  // Set of all uncovered vertices
 
-    // Initialize the set of uncovered vertices
-    for (int i = 0; i < vertices; ++i) {
-        uncovered.insert(i);
+    // gain[v] is the number of uncovered vertices in the closed neighborhood of v.
+    // Buckets are updated lazily: an entry is only moved down once it is popped with a stale gain.
+    // Moved entries land on top of their new bucket, so ties are not broken by index.
+    std::vector<int> gain(vertices);
+    int maxGain = 0;
+    for (int u = 0; u < vertices; ++u) {
+        gain[u] = neighbors[u].size() + 1;
+        maxGain = std::max(maxGain, gain[u]);
+    }
+    std::vector<std::vector<int>> buckets(maxGain + 1);
+    for (int u = vertices - 1; u >= 0; --u) {
+        buckets[gain[u]].push_back(u); // Reverse order so the first round starts at the smallest index
     }
 
     // Greedy selection of dominating set
-    while (!uncovered.empty()) {
-        // Find the vertex with the maximum number of uncovered neighbors
-        int maxCoverage = -1;
-        int bestVertex = -1;
-
-        for (int u : uncovered) {
-            int coverage = 0;
-            for (int v : adj[u].edges) {
-                if (!covered[v]) ++coverage;
-            }
-            if (coverage > maxCoverage) {
-                maxCoverage = coverage;
-                bestVertex = u;
-            }
+    while (maxGain > 0) {
+        if (buckets[maxGain].empty()) {
+            maxGain--;
+            continue;
+        }
+
+        int bestVertex = buckets[maxGain].back();
+        buckets[maxGain].pop_back();
+        if (gain[bestVertex] != maxGain) {
+            if (gain[bestVertex] > 0) buckets[gain[bestVertex]].push_back(bestVertex);
+            continue;
         }
 
         // Add bestVertex to the dominating set
         dominatingSet.push_back(bestVertex);
-        covered[bestVertex] = true;
-        uncovered.erase(bestVertex);
-
-        // Mark all neighbors of bestVertex as covered
-        for (int neighbor : adj[bestVertex].edges) {
-            if (!covered[neighbor]) {
-                covered[neighbor] = true;
-                uncovered.erase(neighbor);
-            }
+
+        // Mark bestVertex and all its neighbors as covered, each of them is worth less to its neighborhood now
+        auto cover = [&](int v) {
+            if (covered[v]) return;
+            covered[v] = true;
+            gain[v]--;
+            for (int w : neighbors[v]) gain[w]--;
+        };
+        cover(bestVertex);
+        for (int neighbor : neighbors[bestVertex]) {
+            cover(neighbor);
         }
     }
 
     return dominatingSet;
 }
 
-double Graph::computeEfficiencyLowerBound(){
+double Graph::computeEfficiencyLowerBound() const{
     double lower_bound = 0.0;
 
     // Iterate over each edge in the graph
     for (int u = 0; u < vertices; ++u) {
-        int max_deg = adj[u].edges.size() + 1;
-        for (int v : adj[u].edges) {
-            int current_deg = adj[v].edges.size() + 1;  
+        int max_deg = neighbors[u].size() + 1;
+        for (int v : neighbors[u]) {
+            int current_deg = neighbors[v].size() + 1;  
             if (current_deg > max_deg){
                 max_deg = current_deg;
             }   
@@ -246,37 +273,76 @@ int Graph::getMaxDegree() const {
 
     // Iterate over all vertices and find the maximum degree
     for (int u = 0; u < adj.size(); ++u) {
-        max_degree = std::max(max_degree, static_cast<int>(adj[u].edges.size()));
+        max_degree = std::max(max_degree, static_cast<int>(neighbors[u].size()));
     }
 
     return max_degree;
 }
 
-int Graph::countTriangles() const{
-    int triangleCount = 0;
+long long Graph::countTriangles(int threads) const{
+    ThreadPool pool(threads);
+    return countTriangles(pool);
+}
 
-    // Iterate over all vertices
+// Every edge is oriented from the lower to the higher (degree, id) rank, so each triangle is seen
+// once at its lowest vertex and out-degrees stay below sqrt(2m). Triangles at u are the common
+// entries of u's and v's out-lists for every out-neighbor v, found by merging the sorted lists.
+// Assumes a simple graph, as the PACE format guarantees.
+long long Graph::countTriangles(ThreadPool& pool) const{
+    auto before = [&](int u, int v) {
+        int du = neighbors.degree(u), dv = neighbors.degree(v);
+        return du < dv || (du == dv && u < v);
+    };
+
+    std::vector<int> outDegrees(vertices, 0);
     for (int u = 0; u < vertices; ++u) {
-        // Check neighbors of u
-        for (int v : adj[u].edges) {
-            if (v > u) { // Ensure u < v to avoid double-counting
-                for (int w : adj[v].edges) {
-                    if (w > v && std::find(adj[u].edges.begin(), adj[u].edges.end(), w) != adj[u].edges.end()) {
-                        // Triangle found: u-v-w
-                        ++triangleCount;
+        for (int v : neighbors[u]) {
+            if (before(u, v)) outDegrees[u]++;
+        }
+    }
+
+    // Filling the rows in order of the target makes every out-list come out sorted
+    CSR out;
+    out.setRowSizes(outDegrees);
+    for (int w = 0; w < vertices; ++w) {
+        for (int u : neighbors[w]) {
+            if (before(u, w)) out.append(u, w);
+        }
+    }
+
+    std::atomic<long long> triangles(0);
+    for (int begin = 0; begin < vertices; begin += propertyBlock) {
+        int end = std::min(vertices, begin + propertyBlock);
+        pool.submit([&, begin, end]() {
+            long long local = 0;
+            for (int u = begin; u < end; ++u) {
+                auto outU = out[u];
+                for (int v : outU) {
+                    auto outV = out[v];
+                    const int* a = outU.begin();
+                    const int* b = outV.begin();
+                    while (a != outU.end() && b != outV.end()) {
+                        if (*a < *b) ++a;
+                        else if (*b < *a) ++b;
+                        else {
+                            ++local;
+                            ++a;
+                            ++b;
+                        }
                     }
                 }
             }
-        }
+            triangles += local;
+        });
     }
-
-    return triangleCount;
+    pool.wait();
+    return triangles;
 }
 
 std::vector<int> Graph::getVertexDegrees() const{
     std::vector<int> degrees(vertices);
     for (int i = 0; i < vertices; ++i) {
-        degrees[i] = adj[i].edges.size(); // Degree is the size of adjacency list
+        degrees[i] = neighbors[i].size(); // Degree is the size of adjacency list
     }
     return degrees;
 }
@@ -296,228 +362,261 @@ std::pair<double, double> Graph::computeDegreeStats() const{
     return {avgDegree, stdDev};
 }
 
-void Graph::graphToHypergraph(const std::string& outputFile) const{
+GraphProperties Graph::computeProperties(int threads) const{
+    GraphProperties properties;
+    properties.vertices = vertices;
+    properties.edges = edges;
+    properties.density = computeDensity();
+
+    ThreadPool pool(threads);
+    pool.submit([&]() {properties.upperBound = greedyDominatingSet().size();});
+
+    // Per block: max degree, degree sum, sum of squared degrees, and the lower bound's share.
+    // Blocks are summed in order afterwards, so the result does not depend on the scheduling
+    struct Block {
+        int maxDegree = 0;
+        long long sum = 0;
+        double squares = 0;
+        double lowerBound = 0;
+    };
+    std::vector<Block> blocks((vertices + propertyBlock - 1) / propertyBlock);
+    for (std::size_t b = 0; b < blocks.size(); ++b) {
+        pool.submit([&, b]() {
+            Block& block = blocks[b];
+            int end = std::min<int>(vertices, (b + 1) * propertyBlock);
+            for (int u = b * propertyBlock; u < end; ++u) {
+                int degree = neighbors[u].size();
+                block.maxDegree = std::max(block.maxDegree, degree);
+                block.sum += degree;
+                block.squares += static_cast<double>(degree) * degree;
+
+                int maxClosed = degree + 1;
+                for (int v : neighbors[u]) maxClosed = std::max(maxClosed, neighbors.degree(v) + 1);
+                block.lowerBound += 1.0 / maxClosed;
+            }
+        });
+    }
+    pool.wait();
+
+    long long sum = 0;
+    double squares = 0;
+    for (const Block& block : blocks) {
+        properties.maxDegree = std::max(properties.maxDegree, block.maxDegree);
+        sum += block.sum;
+        squares += block.squares;
+        properties.lowerBound += block.lowerBound;
+    }
+    if (vertices > 0) {
+        properties.avgDegree = static_cast<double>(sum) / vertices;
+        properties.stdDevDegree = std::sqrt(std::max(0.0, squares / vertices - properties.avgDegree * properties.avgDegree));
+    }
+
+    properties.triangles = countTriangles(pool);
+    return properties;
+}
+
+void Graph::graphToHypergraph(const std::string& outputFile, int threads) const{
     std::ofstream file(outputFile);
     if (!file.is_open()) {
         throw std::runtime_error("Could not open the output file!");
     }
+    graphToHypergraph(file, threads);
+}
+
+void Graph::graphToHypergraph(std::ostream& stream, int threads) const{
+    TextWriter file(stream);
 
     // Writing the hypergraph in custom text format described in README.md of https://github.com/Felerius/findminhs
-    file << vertices << " " << vertices << "\n"; // num_vertices num_hyperedges
+    file << vertices << ' ' << vertices << '\n'; // num_vertices num_hyperedges
 
-    for (int u = 0; u < vertices; ++u) {
+    writeItems(file, vertices, threads, [&](TextWriter& out, size_t u) {
         // Insert closed neighborhoods of each vertex as hyperedge
-        file << adj[u].edges.size() + 1 << " "; // size of the closed neighborhood
-        for (int v : adj[u].edges) {
-            file << v << " "; // print each node in the neighborhood
+        out << neighbors[u].size() + 1 << ' '; // size of the closed neighborhood
+        for (int v : neighbors[u]) {
+            out << v << ' '; // print each node in the neighborhood
         }
-        file << u << "\n"; // Include the vertex itself
-    }
-
-    file.close();
+        out << u << '\n'; // Include the vertex itself
+    });
 }
 
-void Graph::graphToSAT(const std::string& outputFile) const{
-    std::ofstream file(outputFile);
-    if (!file.is_open()) {
+void Graph::graphToSAT(const std::string& outputFile, int threads) const{
+    std::ofstream stream(outputFile);
+    if (!stream.is_open()) {
         throw std::runtime_error("Could not open the output file!");
     }
+    TextWriter file(stream);
 
     // Writing the hypergraph in custom text format described in README.md of https://github.com/Felerius/findminhs
-    file << vertices << " " << vertices << "\n"; // num_vertices num_hyperedges
+    file << vertices << ' ' << vertices << '\n'; // num_vertices num_hyperedges
 
     for (int u = 0; u < vertices; ++u){
-        file << 1 << " ";
+        file << "1 ";
     }
-    file << "\n";
+    file << '\n';
 
-    for (int u = 0; u < vertices; ++u) {
+    writeItems(file, vertices, threads, [&](TextWriter& out, size_t u) {
         // Insert closed neighborhoods of each vertex as hyperedge
-        file << adj[u].edges.size() + 1 << " "; // size of the closed neighborhood
-        for (int v : adj[u].edges) {
-            file << v + 1 << " "; // print each node in the neighborhood
+        out << neighbors[u].size() + 1 << ' '; // size of the closed neighborhood
+        for (int v : neighbors[u]) {
+            out << v + 1 << ' '; // print each node in the neighborhood
         }
-        file << u + 1<< "\n"; // Include the vertex itself
-    }
+        out << u + 1 << '\n'; // Include the vertex itself
+    });
+}
 
-    file.close();
+// Sorted closed neighborhood of u without repetitions, written into a buffer the caller reuses
+void Graph::closedNeighborhood(int u, bool visibleOnly, std::vector<int>& neighborhood) const{
+    auto row = neighbors[u];
+    neighborhood.assign(row.begin() + (visibleOnly ? adj[u].offset : 0), row.end());
+    neighborhood.push_back(u); // Include the vertex itself
+    std::sort(neighborhood.begin(), neighborhood.end());
+    neighborhood.erase(std::unique(neighborhood.begin(), neighborhood.end()), neighborhood.end());
 }
 
-void Graph::writeHittingSetILP(const std::string &outputFile) const {
-    std::ofstream file(outputFile);
-    if (!file.is_open()) {
-        throw std::runtime_error("Failed to open file: " + outputFile);
-    }
+// Shared by writeHittingSetILP and writeHittingSetLP: constraints of the active vertices that are
+// not skipped, over their visible closed neighborhoods
+void Graph::writeHittingSetModel(std::ostream& stream, bool ILP, bool skipCovered, int threads) const{
+    TextWriter file(stream);
 
     // Write the objective function
     file << "Minimize\n obj: ";
-    bool first = true;
-    for (int i = 0; i < vertices; ++i) {
-        if (!adj[i].active) continue; // Skip inactive vertices
-        if (!first) {
-            file << " + ";
+    int first = 0;
+    while (first < vertices && !adj[first].active) first++;
+    writeItems(file, vertices, threads, [&](TextWriter& out, size_t i) {
+        if (!adj[i].active) return; // Skip inactive vertices
+        if (static_cast<int>(i) != first) {
+            out << " + ";
         }
-        file << "x" << i;
-        first = false;
-    }
+        out << 'x' << i;
+    });
     file << "\n\nSubject To\n";
 
     // Write the constraints (one per closed neighborhood)
-    for (int u = 0; u < vertices; ++u) {
-        if (!adj[u].active) continue; // Skip inactive vertices or vertices that are already covered
-        file << " c" << u + 1 << ": ";
-        std::set<int> neighborhood;
-        neighborhood.insert(u); // Include the vertex itself
-        for (int j = adj[u].offset; j < adj[u].edges.size(); j++){
-            int v = adj[u].edges[j];
-            neighborhood.insert(v);
-        }
+    writeItems(file, vertices, threads, [&](TextWriter& out, size_t u) {
+        if (!adj[u].active || (skipCovered && adj[u].covered)) return; // Skip inactive vertices or vertices that are already covered
+        out << " c" << u + 1 << ": ";
+        thread_local std::vector<int> neighborhood;
+        closedNeighborhood(u, true, neighborhood);
         int count = 0;
         for (int v : neighborhood) {
             if (count > 0) {
-                file << " + ";
+                out << " + ";
             }
-            file << "x" << v;
+            out << 'x' << v;
             count++;
         }
-        file << " >= 1\n";
-    }
+        out << " >= 1\n";
+    });
 
     // Write bounds and variable types
     file << "\nBounds\n";
-    for (int i = 0; i < vertices; ++i) {
-        if (!adj[i].active) continue; // Skip inactive vertices
-        file << " 0 <= x" << i << " <= 1\n";
-    }
+    writeItems(file, vertices, threads, [&](TextWriter& out, size_t i) {
+        if (!adj[i].active) return; // Skip inactive vertices
+        out << " 0 <= x" << i << " <= 1\n";
+    });
 
-    file << "\nBinary\n";
-    for (int i = 0; i < vertices; ++i) {
-        if (!adj[i].active) continue; // Skip inactive vertices
-        file << " x" << i << "\n";
+    if (ILP) {
+        file << "\nBinary\n";
+        writeItems(file, vertices, threads, [&](TextWriter& out, size_t i) {
+            if (!adj[i].active) return; // Skip inactive vertices
+            out << " x" << i << '\n';
+        });
     }
 
     file << "End\n";
-    file.close();
 }
 
-void Graph::writeHittingSetLP(const std::string &outputFile) const {
+void Graph::writeHittingSetILP(const std::string &outputFile, int threads) const {
     std::ofstream file(outputFile);
     if (!file.is_open()) {
         throw std::runtime_error("Failed to open file: " + outputFile);
     }
+    writeHittingSetModel(file, true, false, threads);
+}
 
-    // Write the objective function
-    file << "Minimize\n obj: ";
-    bool first = true;
-    for (int i = 0; i < vertices; ++i) {
-        if (!adj[i].active) continue; // Skip inactive vertices
-        if (!first) {
-            file << " + ";
-        }
-        file << "x" << i;
-        first = false;
-    }
-    file << "\n\nSubject To\n";
-
-    // Write the constraints (one per closed neighborhood)
-    for (int u = 0; u < vertices; ++u) {
-        if (!adj[u].active || adj[u].covered) continue; // Skip inactive vertices or vertices that are already covered
-        file << " c" << u + 1 << ": ";
-        std::set<int> neighborhood;
-        neighborhood.insert(u); // Include the vertex itself
-        for (int j = adj[u].offset; j < adj[u].edges.size(); j++){
-            int v = adj[u].edges[j];
-            neighborhood.insert(v);
-        }
-        int count = 0;
-        for (int v : neighborhood) {
-            if (count > 0) {
-                file << " + ";
-            }
-            file << "x" << v;
-            count++;
-        }
-        file << " >= 1\n";
-    }
-
-    // Write bounds and variable types
-    file << "\nBounds\n";
-    for (int i = 0; i < vertices; ++i) {
-        if (!adj[i].active) continue; // Skip inactive vertices
-        file << " 0 <= x" << i << " <= 1\n";
+void Graph::writeHittingSetLP(const std::string &outputFile, int threads) const {
+    std::ofstream file(outputFile);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open file: " + outputFile);
     }
-
-    file << "End\n";
-    file.close();
+    writeHittingSetModel(file, false, true, threads);
 }
 
-void Graph::writeHittingSetILP_check(const std::string &outputFile, int k) const {
+void Graph::writeHittingSetILP_check(const std::string &outputFile, int k, int threads) const {
     std::ofstream file(outputFile);
     if (!file.is_open()) {
         throw std::runtime_error("Failed to open file: " + outputFile);
     }
+    writeHittingSetILP_check(file, k, threads);
+}
+
+void Graph::writeHittingSetILP_check(std::ostream& stream, int k, int threads) const{
+    TextWriter file(stream);
+
+    // Sum over all variables, used by the objective and the size constraint
+    auto writeSum = [&]() {
+        writeItems(file, vertices, threads, [&](TextWriter& out, size_t i) {
+            out << 'x' << i;
+            if (static_cast<int>(i) < vertices - 1) {
+                out << " + ";
+            }
+        });
+    };
 
     // Write the objective function
     file << "Minimize\n obj: ";
-    for (int i = 0; i < vertices; ++i) {
-        file << "x" << i;
-        if (i < vertices - 1) {
-            file << " + ";
-        }
-    }
+    writeSum();
     file << "\n\nSubject To\n";
 
     // Write the constraints (one per closed neighborhood)
-    for (int u = 0; u < vertices; ++u) {
-        file << " c" << u + 1 << ": ";
-        std::set<int> neighborhood;
-        neighborhood.insert(u); // Include the vertex itself
-        for (int v : adj[u].edges) {
-            neighborhood.insert(v); // Include its neighbors
-        }
-        int count = 0;
+    writeItems(file, vertices, threads, [&](TextWriter& out, size_t u) {
+        out << " c" << u + 1 << ": ";
+        thread_local std::vector<int> neighborhood;
+        closedNeighborhood(u, false, neighborhood);
+        size_t count = 0;
         for (int v : neighborhood) {
-            file << "x" << v;
+            out << 'x' << v;
             if (++count < neighborhood.size()) {
-                file << " + ";
+                out << " + ";
             }
         }
-        file << " >= 1\n";
-    }
+        out << " >= 1\n";
+    });
 
     // Add the constraint to limit the number of selected elements to k
     file << " c_total: ";
-    for (int i = 0; i < vertices; ++i) {
-        file << "x" << i;
-        if (i < vertices - 1) {
-            file << " + ";
-        }
-    }
-    file << " <= " << k << "\n";
+    writeSum();
+    file << " <= " << k << '\n';
 
     // Write bounds and variable types
     file << "\nBounds\n";
-    for (int i = 0; i < vertices; ++i) {
-        file << " 0 <= x" << i << " <= 1\n";
-    }
+    writeItems(file, vertices, threads, [&](TextWriter& out, size_t i) {
+        out << " 0 <= x" << i << " <= 1\n";
+    });
 
     file << "\nBinary\n";
-    for (int i = 0; i < vertices; ++i) {
-        file << " x" << i << "\n";
-    }
+    writeItems(file, vertices, threads, [&](TextWriter& out, size_t i) {
+        out << " x" << i << '\n';
+    });
 
     file << "End\n";
-    file.close();
 }
 
-// DFS helper function to traverse and collect nodes in a connected component
+// Iterative DFS collecting every node reachable from node, an explicit stack keeps long paths off the call stack
 void Graph::dfs(int node, std::vector<bool>& visited, std::vector<int>& component) const {
+    std::vector<int> stack = {node};
     visited[node] = true;
-    component.push_back(node);
 
-    for (int neighbor : adj[node].edges) {
-        if (!visited[neighbor]) {
-            dfs(neighbor, visited, component);
+    while (!stack.empty()) {
+        int current = stack.back();
+        stack.pop_back();
+        component.push_back(current);
+
+        for (int neighbor : neighbors[current]) {
+            if (!visited[neighbor]) {
+                visited[neighbor] = true;
+                stack.push_back(neighbor);
+            }
         }
     }
 }
@@ -528,6 +627,9 @@ std::pair<std::vector<std::vector<std::vector<int>>>, std::vector<std::vector<in
     std::vector<std::vector<std::vector<int>>> connectedComponents;
     std::vector<std::vector<int>> reverseMappings;
 
+    // Every node belongs to exactly one component, so one array maps old to new indices for all of them
+    std::vector<int> oldToNew(vertices, -1);
+
     for (int i = 0; i < vertices; ++i) {
         if (!visited[i]) {
             std::vector<int> componentNodes;  // Nodes in the current connected component
@@ -535,30 +637,26 @@ std::pair<std::vector<std::vector<std::vector<int>>>, std::vector<std::vector<in
 
             // Create a subgraph for the current connected component
             std::vector<std::vector<int>> subgraph(componentNodes.size());
-            std::map<int, int> oldToNew;  // Map old indices to new indices in the subgraph
             std::vector<int> newToOld(componentNodes.size()); // Reverse map: subgraph -> old graph
-            //TODO: Change map here?
 
-            for (int j = 0; j < componentNodes.size(); ++j) {
+            for (size_t j = 0; j < componentNodes.size(); ++j) {
                 oldToNew[componentNodes[j]] = j;  // Assign new indices
                 newToOld[j] = componentNodes[j];
             }
 
-            // Populate adjacency list for the subgraph
+            // Populate adjacency list for the subgraph, all neighbors are in the same component
             for (int node : componentNodes) {
-                std::vector<int> neighborsInSubgraph;
-                for (int neighbor : adj[node].edges) {
-                    if (oldToNew.find(neighbor) != oldToNew.end()) {
-                        neighborsInSubgraph.push_back(oldToNew[neighbor]);
-                    }
+                std::vector<int>& neighborsInSubgraph = subgraph[oldToNew[node]];
+                neighborsInSubgraph.reserve(neighbors[node].size());
+                for (int neighbor : neighbors[node]) {
+                    neighborsInSubgraph.push_back(oldToNew[neighbor]);
                 }
-                subgraph[oldToNew[node]] = neighborsInSubgraph;
             }
 
-            connectedComponents.push_back(subgraph);
-            reverseMappings.push_back(newToOld);
+            connectedComponents.push_back(std::move(subgraph));
+            reverseMappings.push_back(std::move(newToOld));
         }
     }
 
-    return std::make_pair(connectedComponents, reverseMappings);
-}
\ No newline at end of file
+    return std::make_pair(std::move(connectedComponents), std::move(reverseMappings));
+}
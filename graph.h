@@ -13,8 +13,24 @@
 #include <numeric>
 #include <cassert>
 
+#include "csr.h"
+
+class ThreadPool;
+
+// Statistics of the properties CSV, see Graph::computeProperties
+struct GraphProperties {
+    int vertices = 0;
+    int edges = 0;
+    double density = 0;
+    int maxDegree = 0;
+    double lowerBound = 0;      // Efficiency lower bound
+    int upperBound = 0;         // Size of the greedy dominating set
+    long long triangles = 0;
+    double avgDegree = 0;
+    double stdDevDegree = 0;
+};
+
 struct Node {
-    std::vector<int> edges;
     int offset = 0; //offset to visible nodes in neighborhood
     bool active = true;
     bool covered = false;
@@ -24,11 +40,18 @@ class Graph {
 private:
     int vertices;
     int edges = 0;
-    std::vector<Node> adj;  // Adjacency list representation
+    std::vector<Node> adj;  // Per-vertex visibility state
+    CSR neighbors;          // Adjacency lists, the first adj[u].offset entries of row u are invisible
+    std::vector<std::size_t> mirror; // Position of the reverse entry of every adjacency entry, kept up to date by swapEntries
 
+    void swapEntries(std::size_t a, std::size_t b);
     void dfs(int node, std::vector<bool>& visited, std::vector<int>& component) const;
+    void closedNeighborhood(int u, bool visibleOnly, std::vector<int>& neighborhood) const;
+    void writeHittingSetModel(std::ostream& file, bool ILP, bool skipCovered, int threads) const;
+    long long countTriangles(ThreadPool& pool) const;
 public:
     Graph(int vertices);
+    void reserveNeighbors(const std::vector<int>& degrees);
     void addEdge(int u, int v);
     void makeNodeInvisible(int u);
     void makeNodeVisible(int u);
@@ -38,23 +61,30 @@ public:
     int reductionDominatingVertex(std::vector<int>& dominatingSet, bool verbose);
     int reductionSingleEdgeVertex(std::vector<int>& dominatingSet, bool verbose);
 
-    std::vector<int> greedyDominatingSet();
-    double computeEfficiencyLowerBound();
+    std::vector<int> greedyDominatingSet() const;
+    double computeEfficiencyLowerBound() const;
     double computeDensity() const;
     int getMaxDegree() const;
 
     int getVertices(){return vertices;};
     int getEdges(){return edges;};
-    int countTriangles() const;
+    long long countTriangles(int threads = 1) const;
     std::vector<int> getVertexDegrees() const;
     std::pair<double, double> computeDegreeStats() const;
 
-    void graphToHypergraph(const std::string& outputFile) const;
-    void graphToSAT(const std::string& outputFile) const;
+    // All statistics at once on threads threads (<= 0 uses all): degrees and the lower bound come
+    // from one pass over the rows in vertex blocks, the greedy solution is found alongside
+    GraphProperties computeProperties(int threads = 1) const;
+
+    // Model exports, formatted on threads threads (<= 0 uses all); the output does not depend on it
+    void graphToHypergraph(const std::string& outputFile, int threads = 1) const;
+    void graphToHypergraph(std::ostream& file, int threads = 1) const;
+    void graphToSAT(const std::string& outputFile, int threads = 1) const;
 
-    void writeHittingSetILP(const std::string &outputFile) const;
-    void writeHittingSetLP(const std::string &outputFile) const;
-    void writeHittingSetILP_check(const std::string &outputFile, int k) const;
+    void writeHittingSetILP(const std::string &outputFile, int threads = 1) const;
+    void writeHittingSetLP(const std::string &outputFile, int threads = 1) const;
+    void writeHittingSetILP_check(const std::string &outputFile, int k, int threads = 1) const;
+    void writeHittingSetILP_check(std::ostream& file, int k, int threads = 1) const;
 
     std::pair<std::vector<std::vector<std::vector<int>>>, std::vector<std::vector<int>>> getConnectedComponents() const;
 
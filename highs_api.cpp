@@ -0,0 +1,142 @@
+#include "highs_api.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#ifdef HAVE_HIGHS
+#include "Highs.h"
+
+namespace {
+
+// Model of the live part only: column c is vertex vertexOf[c], row r the r-th active hyperedge
+struct CoveringModel {
+    HighsLp lp;
+    std::vector<int> vertexOf;
+};
+
+CoveringModel buildModel(const Hypergraph& hypergraph, bool relaxation){
+    int n = hypergraph.numVertices();
+    int m = hypergraph.numHyperedges();
+
+    std::vector<int> row(m, -1);
+    int rows = 0;
+    for (int e = 0; e < m; ++e) {
+        if (!hypergraph.isActive(e)) continue;
+
+        // Live counts may not exist on an unreduced hypergraph, so usable vertices are looked up
+        auto vertices = hypergraph.verticesOf(e);
+        if (std::none_of(vertices.begin(), vertices.end(), [&](int v) {return hypergraph.isUsable(v);})) {
+            throw std::runtime_error("Instance has a hyperedge that no vertex can cover");
+        }
+        row[e] = rows++;
+    }
+
+    CoveringModel model;
+    HighsLp& lp = model.lp;
+    lp.num_row_ = rows;
+    lp.sense_ = ObjSense::kMinimize;
+    lp.row_lower_.assign(rows, 1.0);
+    lp.row_upper_.assign(rows, kHighsInf);
+
+    // Columns are the incidence rows of the usable vertices, filtered to active hyperedges
+    lp.a_matrix_.format_ = MatrixFormat::kColwise;
+    lp.a_matrix_.start_.push_back(0);
+    for (int v = 0; v < n; ++v) {
+        if (!hypergraph.isUsable(v)) continue;
+        model.vertexOf.push_back(v);
+        for (int e : hypergraph.edgesOf(v)) {
+            if (row[e] == -1) continue;
+            lp.a_matrix_.index_.push_back(row[e]);
+            lp.a_matrix_.value_.push_back(1.0);
+        }
+        lp.a_matrix_.start_.push_back(lp.a_matrix_.index_.size());
+    }
+
+    int columns = model.vertexOf.size();
+    lp.num_col_ = columns;
+    lp.a_matrix_.num_col_ = columns;
+    lp.a_matrix_.num_row_ = rows;
+    lp.col_cost_.assign(columns, 1.0);
+    lp.col_lower_.assign(columns, 0.0);
+    lp.col_upper_.assign(columns, 1.0);
+    if (!relaxation) lp.integrality_.assign(columns, HighsVarType::kInteger);
+    return model;
+}
+
+} // namespace
+
+bool highsApiAvailable(){
+    return true;
+}
+
+HighsApiResult solveWithHighsApi(const Hypergraph& hypergraph, const HighsApiOptions& options){
+    HighsApiResult result;
+    result.values.assign(hypergraph.numVertices(), 0.0);
+    auto model = buildModel(hypergraph, options.relaxation);
+    if (model.lp.num_row_ == 0) {
+        result.objective = 0;
+        result.optimal = true;
+        return result;
+    }
+
+    Highs highs;
+    highs.setOptionValue("output_flag", options.verbose);
+    if (options.timeLimit > 0) highs.setOptionValue("time_limit", options.timeLimit);
+    if (!options.relaxation) {
+        // The objective is integral, so any gap below 1 already proves optimality
+        highs.setOptionValue("mip_rel_gap", 0.0);
+        highs.setOptionValue("mip_abs_gap", 1.0 - 1e-6);
+    }
+
+    // HiGHS polls its interrupt callbacks in simplex, IPM and branch and bound alike
+    if (options.stop) {
+        highs.setCallback([](int, const std::string&, const auto*, auto* dataIn, void* stop) {
+            if (*static_cast<const std::atomic<bool>*>(stop)) dataIn->user_interrupt = 1;
+        }, const_cast<std::atomic<bool>*>(options.stop));
+        highs.startCallback(kCallbackSimplexInterrupt);
+        highs.startCallback(kCallbackIpmInterrupt);
+        highs.startCallback(kCallbackMipInterrupt);
+    }
+
+    if (highs.passModel(std::move(model.lp)) == HighsStatus::kError) {
+        throw std::runtime_error("HiGHS rejected the model");
+    }
+    if (highs.run() == HighsStatus::kError) {
+        throw std::runtime_error("HiGHS failed to solve the model");
+    }
+
+    HighsModelStatus status = highs.getModelStatus();
+    if (status == HighsModelStatus::kInfeasible) {
+        throw std::runtime_error("HiGHS reports the model as infeasible");
+    }
+
+    const HighsInfo& info = highs.getInfo();
+    const HighsSolution& solution = highs.getSolution();
+    result.optimal = status == HighsModelStatus::kOptimal;
+    result.time = highs.getRunTime();
+    result.bound = options.relaxation ? (result.optimal ? info.objective_function_value : 0) : info.mip_dual_bound;
+
+    if (solution.value_valid) {
+        result.objective = info.objective_function_value;
+        for (size_t c = 0; c < model.vertexOf.size(); ++c) {
+            int v = model.vertexOf[c];
+            result.values[v] = solution.col_value[c];
+            if (solution.col_value[c] > 1.0 - 1e-6 || (!options.relaxation && solution.col_value[c] > 0.5)) {
+                result.solution.push_back(v);
+            }
+        }
+    }
+    return result;
+}
+
+#else
+
+bool highsApiAvailable(){
+    return false;
+}
+
+HighsApiResult solveWithHighsApi(const Hypergraph&, const HighsApiOptions&){
+    throw std::runtime_error("Built without the HiGHS library, install HiGHS and reconfigure to use highs_api");
+}
+
+#endif
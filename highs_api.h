@@ -0,0 +1,33 @@
+#ifndef HIGHS_API_H
+#define HIGHS_API_H
+
+#include <vector>
+#include <atomic>
+
+#include "hypergraph2.h"
+
+struct HighsApiOptions {
+    double timeLimit = 0;       // Seconds, 0 means unlimited
+    bool relaxation = false;    // Solve the LP relaxation instead of the ILP
+    bool verbose = false;       // Let HiGHS print its log
+    const std::atomic<bool>* stop = nullptr; // Interrupts the solve like the time limit
+};
+
+struct HighsApiResult {
+    std::vector<int> solution;  // Sorted, 0-based vertices at 1; for the relaxation those at 1 in the optimum
+    std::vector<double> values; // Value of every vertex of the hypergraph, 0 for unusable ones
+    double objective = -1;      // -1 if HiGHS found no solution
+    double bound = 0;           // Proven lower bound on the objective
+    bool optimal = false;
+    double time = 0;            // Run time reported by HiGHS
+};
+
+// True if the program was built against the HiGHS library (HAVE_HIGHS)
+bool highsApiAvailable();
+
+// Hands the active part of the hypergraph to HiGHS as a column-wise model built straight from
+// the incidence rows: one column per usable vertex, one covering row per active hyperedge.
+// Throws if the build has no HiGHS or an active hyperedge has no usable vertex.
+HighsApiResult solveWithHighsApi(const Hypergraph& hypergraph, const HighsApiOptions& options = HighsApiOptions());
+
+#endif // HIGHS_API_H
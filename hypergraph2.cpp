@@ -1,28 +1,47 @@
 #include "hypergraph2.h"
 
+#include "writer.h"
+
 Hypergraph::Hypergraph(int num_hyperedges, int num_constraints, int num_variables) : hyperedges(num_hyperedges), useConstraint(num_constraints, true), useVariable(num_variables, true) {}
 
+// Finished, sorted rows in both directions, as read back from a snapshot
+Hypergraph::Hypergraph(CSR hyperedges, CSR vertex_to_hyperedges, std::vector<bool> useConstraint, std::vector<bool> useVariable)
+    : hyperedges(std::move(hyperedges)), vertex_to_hyperedges(std::move(vertex_to_hyperedges)), useConstraint(std::move(useConstraint)), useVariable(std::move(useVariable)) {}
+
+void Hypergraph::reserveHyperedges(const std::vector<int>& sizes){
+    hyperedges.setRowSizes(sizes);
+}
+
 void Hypergraph::initEdge(int vertices){
     for (int i = 0; i < vertices; i++){
-        hyperedges[i].push_back(i); // The vertex itself is always included in the closed neighborhood
+        hyperedges.append(i, i); // The vertex itself is always included in the closed neighborhood
     }
 }
 
 void Hypergraph::addEdge(int u, int v){
-    hyperedges[u-1].push_back(v-1);
-    hyperedges[v-1].push_back(u-1);
+    hyperedges.append(u-1, v-1);
+    hyperedges.append(v-1, u-1);
+}
+
+void Hypergraph::addVertexToHyperedge(int edge, int vertex){
+    hyperedges.append(edge, vertex);
 }
 
+// Sorts and deduplicates every hyperedge, then derives the incidence lists as its transpose.
+// Afterwards all rows in both directions are sorted, which the subset tests rely on.
 void Hypergraph::setVertexToHyperedges(){
-    this->vertex_to_hyperedges = hyperedges;
+    hyperedges.sortRows();
+    this->vertex_to_hyperedges = hyperedges.transpose(useVariable.size());
 }
 
 void Hypergraph::setHyperedges(const std::vector<std::vector<int>>& sets){
-    this->hyperedges = sets;
+    this->hyperedges.assign(sets);
+    this->hyperedges.sortRows();
 }
 
 void Hypergraph::setVertexToHyperedges(const std::vector<std::vector<int>>& part_of){
-    this->vertex_to_hyperedges = part_of;
+    this->vertex_to_hyperedges.assign(part_of);
+    this->vertex_to_hyperedges.sortRows();
 }
 
 void Hypergraph::printHypergraph(){
@@ -41,43 +60,128 @@ void Hypergraph::printHypergraph(){
 
 
 
+// All flag changes of the reductions go through the following helpers, which keep the
+// live counts up to date and, while reduceExhaustively runs, queue what the change touched.
+
+void Hypergraph::initLiveCounts(){
+    liveSize.assign(hyperedges.size(), 0);
+    liveDegree.assign(vertex_to_hyperedges.size(), 0);
+    for (size_t e = 0; e < hyperedges.size(); ++e) {
+        for (int v : hyperedges[e]) {
+            if (useVariable[v]) liveSize[e]++;
+            if (useConstraint[e]) liveDegree[v]++;
+        }
+    }
+}
+
+void Hypergraph::queueEdge(int e){
+    if (!tracking || edgeQueued[e]) return;
+    edgeQueued[e] = true;
+    edgeQueue.push_back(e);
+}
+
+void Hypergraph::queueVertex(int v){
+    if (!tracking || vertexQueued[v]) return;
+    vertexQueued[v] = true;
+    vertexQueue.push_back(v);
+}
+
+// The usable vertex of hyperedge e other than v, only meaningful if e has exactly two
+int Hypergraph::partner(int e, int v) const{
+    for (int u : hyperedges[e]) {
+        if (u != v && useVariable[u]) return u;
+    }
+    return -1;
+}
+
+void Hypergraph::disableVariable(int v){
+    useVariable[v] = false;
+    if (trailing) trail.push_back({TrailEntry::Variable, v});
+    for (int e : vertex_to_hyperedges[v]) {
+        liveSize[e]--;
+        if (useConstraint[e]) queueEdge(e); // e lost a vertex, it may be forced or dominating now
+    }
+}
+
+void Hypergraph::disableConstraint(int e){
+    useConstraint[e] = false;
+    if (trailing) trail.push_back({TrailEntry::Constraint, e});
+    for (int u : hyperedges[e]) {
+        liveDegree[u]--;
+        if (!useVariable[u]) continue;
+        queueVertex(u); // u covers less now, it may be dominated
+
+        // Partners of u see fewer external elements in the counting rule
+        if (!tracking) continue;
+        for (int other : vertex_to_hyperedges[u]) {
+            if (useConstraint[other] && liveSize[other] == 2) queueVertex(partner(other, u));
+        }
+    }
+}
+
+void Hypergraph::chooseVertex(int v, std::set<int>& dominatingSet){
+    bool inserted = dominatingSet.insert(v).second;
+    if (trailing && inserted) trail.push_back({TrailEntry::Chosen, v}); // Already chosen vertices stay on undo
+    if (useVariable[v]) disableVariable(v);
+    for (int e : vertex_to_hyperedges[v]) {
+        if (useConstraint[e]) disableConstraint(e);
+    }
+}
+
+// Sizes of the live rows are tracked incrementally; this only computes them on first use
+void Hypergraph::ensureLiveCounts(){
+    if (liveSize.size() != hyperedges.size() || liveDegree.size() != vertex_to_hyperedges.size()) {
+        initLiveCounts();
+    }
+}
+
 int Hypergraph::reductionIsolatedVertex(std::set<int>& dominatingSet, bool verbose){
+    ensureLiveCounts();
+    profile = Profile::current();
     int reductionCount = 0;
     for (size_t i = 0; i < hyperedges.size(); ++i) {
-        if (!useConstraint[i]) continue; // Make sure we still need to cover i
+        if (chooseIfIsolated(i, dominatingSet, verbose)) reductionCount++;
+    }
+    return reductionCount;
+}
 
-        if (hyperedges[i].size() == 1) {
-            auto& vertex = hyperedges[i][0];
-            if (!useVariable[vertex]) continue;
+bool Hypergraph::chooseIfIsolated(int i, std::set<int>& dominatingSet, bool verbose){
+    if (!useConstraint[i] || liveSize[i] != 1) return false; // Make sure we still need to cover i
+    RuleTimer timer(profile, Profile::IsolatedVertex);
 
-            dominatingSet.insert(vertex);
-            useVariable[vertex] = false;
-            for (auto edge : vertex_to_hyperedges[vertex]){
-                useConstraint[edge] = false;
-            }
-            reductionCount++;
+    // Only one vertex is left that can cover i, so it is part of every solution
+    for (int vertex : hyperedges[i]) {
+        if (!useVariable[vertex]) continue;
 
-            if (verbose) std::cout << "Edge "  << i+1 << " was isolated." << std::endl;
-        }
+        chooseVertex(vertex, dominatingSet);
+        if (verbose) std::cout << "Edge "  << i+1 << " was isolated." << std::endl;
+        return true;
     }
-    return reductionCount;
+    return false;
 }
 
 int Hypergraph::reductionSingleEdgeVertex(std::set<int>& dominatingSet, bool verbose){
+    ensureLiveCounts();
+    profile = Profile::current();
     int reductionCount = 0;
     for (size_t i = 0; i < hyperedges.size(); ++i) {
         if (!useConstraint[i]) continue; // Make sure we still need to cover i
 
-        if (hyperedges[i].size() == 2) {
-            int neighbor = hyperedges[i][1];
+        RuleTimer timer(profile, Profile::SingleEdgeVertex);
+        auto edge = hyperedges[i];
+        int self = static_cast<int>(i);
+        if (edge.size() == 2 && (edge[0] == self || edge[1] == self)) {
+            int neighbor = edge[0] != self ? edge[0] : edge[1];
             if (!useVariable[neighbor]) continue;
 
-            dominatingSet.insert(neighbor);
-            useVariable[i] = false;     // Will never need i in optimal solution
-            useVariable[neighbor] = false;
-            for (auto v : hyperedges[neighbor]){ // All adjacent vertices' constraints are now inactive/satisfied by neighbor
-                useConstraint[v] = false;
-            }
+            // The neighbor has to cover everything i covers, which always holds for closed neighborhoods
+            auto covered = vertex_to_hyperedges[self];
+            auto neighborCovered = vertex_to_hyperedges[neighbor];
+            if (profile) profile->counters[Profile::SubsetTests]++;
+            if (!std::includes(neighborCovered.begin(), neighborCovered.end(), covered.begin(), covered.end())) continue;
+
+            if (useVariable[self]) disableVariable(self); // Will never need i in optimal solution
+            chooseVertex(neighbor, dominatingSet); // All adjacent vertices' constraints are now inactive/satisfied by neighbor
             reductionCount++;
 
             if (verbose) std::cout << "Edge "  << neighbor+1 << " chosen over " << i+1 << std::endl;
@@ -87,294 +191,585 @@ int Hypergraph::reductionSingleEdgeVertex(std::set<int>& dominatingSet, bool ver
 }
 
 int Hypergraph::reductionDominatingEdge(std::set<int>& dominatingSet, bool verbose){
+    ensureLiveCounts();
+    profile = Profile::current();
     int reductionCount = 0;
-    for (size_t i = 0; i < hyperedges.size(); ++i) {
-        if (!useConstraint[i]) continue; // Make sure i is not yet dominated
+    for (size_t j = 0; j < hyperedges.size(); ++j) {
+        reductionCount += disableSupersetsOf(j, verbose);
+    }
+    return reductionCount;
+}
 
-        std::set<int> vertexSet(hyperedges[i].begin(), hyperedges[i].end());
+// Tests whether every usable vertex of hyperedge j is part of hyperedge i, both rows are sorted
+bool Hypergraph::liveVerticesContained(int j, int i) const{
+    auto superset = hyperedges[i];
+    const int* it = superset.begin();
+    for (int v : hyperedges[j]) {
+        if (!useVariable[v]) continue;
+        while (it != superset.end() && *it < v) ++it;
+        if (it == superset.end() || *it != v) return false;
+    }
+    return true;
+}
 
-        for (size_t j = 0; j < hyperedges.size(); ++j) {
-            if (i == j) continue; // Skip itself; we allow dominating already satisfied constraints, in this case the dominating constraint would also be satisfied
-            // TODO: Worth?
+// Tests whether every active hyperedge of vertex j also contains vertex i, both rows are sorted
+bool Hypergraph::liveEdgesContained(int j, int i) const{
+    auto superset = vertex_to_hyperedges[i];
+    const int* it = superset.begin();
+    for (int e : vertex_to_hyperedges[j]) {
+        if (!useConstraint[e]) continue;
+        while (it != superset.end() && *it < e) ++it;
+        if (it == superset.end() || *it != e) return false;
+    }
+    return true;
+}
 
-            if (hyperedges[j].size() >= hyperedges[i].size()) continue; // If other edge contains more vertices, initial edge can't dominate
-            // TODO: delete same hyperedges in extra step somewhere, only letting one remain
-        
-            std::set<int> otherVertexSet(hyperedges[j].begin(), hyperedges[j].end());
+int Hypergraph::disableSupersetsOf(int j, bool verbose){
+    if (!useConstraint[j] || liveSize[j] == 0) return 0; // Only a constraint we still need can stand in for others
+    RuleTimer timer(profile, Profile::DominatingEdge);
 
-            // If edge i dominates edge j, we only need to satisfy edge j since this will also always satisfy edge i
-            if (std::includes(vertexSet.begin(), vertexSet.end(), otherVertexSet.begin(), otherVertexSet.end())) {
-                useConstraint[i] = false;
-                reductionCount++;
+    // Every superset of j contains j's rarest usable vertex, so its incidence list holds all candidates
+    int rarest = -1;
+    for (int v : hyperedges[j]) {
+        if (!useVariable[v]) continue;
+        if (rarest == -1 || vertex_to_hyperedges.degree(v) < vertex_to_hyperedges.degree(rarest)) rarest = v;
+    }
 
-                if (verbose) std::cout << "Edge " << i + 1 << " dominates " << j + 1 << std::endl;
-            }
+    int reductionCount = 0;
+    for (int i : vertex_to_hyperedges[rarest]) {
+        if (i == j || !useConstraint[i]) continue; // Make sure i is not yet dominated
+        if (profile) profile->counters[Profile::CandidatePairs]++;
+
+        if (liveSize[i] < liveSize[j]) continue; // If other edge contains less vertices, it can't be a superset
+        if (liveSize[i] == liveSize[j] && i < j) continue; // Among identical edges the first one is kept
+        if (profile) profile->counters[Profile::SubsetTests]++;
+
+        // If edge i dominates edge j, we only need to satisfy edge j since this will also always satisfy edge i
+        if (liveVerticesContained(j, i)) {
+            disableConstraint(i);
+            reductionCount++;
+
+            if (verbose) std::cout << "Edge " << i + 1 << " dominates " << j + 1 << std::endl;
         }
     }
     return reductionCount;
 }
 
 int Hypergraph::reductionDominatingVertex(std::set<int>& dominatingSet, bool verbose){
+    ensureLiveCounts();
+    profile = Profile::current();
     int reductionCount = 0;
-    for (size_t i = 0; i < vertex_to_hyperedges.size(); ++i) {
-        if (!useVariable[i]) continue; // Make sure i is not yet dominated
+    for (size_t j = 0; j < vertex_to_hyperedges.size(); ++j) {
+        if (!useVariable[j]) continue; // Skip already dominated variables
 
-        std::set<int> edgeSet(vertex_to_hyperedges[i].begin(), vertex_to_hyperedges[i].end());
+        if (disableIfDominated(j, verbose)) reductionCount++;
+    }
+    return reductionCount;
+}
 
-        for (size_t j = 0; j < hyperedges.size(); ++j) {
-            if (i == j || !useVariable[j]) continue; // Skip itself and already dominated variables
+bool Hypergraph::disableIfDominated(int j, bool verbose){
+    RuleTimer timer(profile, Profile::DominatingVertex);
+    if (liveDegree[j] == 0) {
+        disableVariable(j); // Covers no constraint we still need, so never needed
+        return true;
+    }
 
-            if (vertex_to_hyperedges[j].size() > vertex_to_hyperedges[i].size()) continue; // If other vertex contains more edges, initial vertex can't dominate
+    // Any vertex dominating j is part of every active hyperedge of j, in particular of the smallest one
+    int smallest = -1;
+    for (int e : vertex_to_hyperedges[j]) {
+        if (!useConstraint[e]) continue;
+        if (smallest == -1 || liveSize[e] < liveSize[smallest]) smallest = e;
+    }
 
-            std::set<int> otherEdgeSet(vertex_to_hyperedges[j].begin(), vertex_to_hyperedges[j].end());
+    for (int i : hyperedges[smallest]) {
+        if (i == j || !useVariable[i]) continue; // Skip itself and already dominated variables
+        if (profile) profile->counters[Profile::CandidatePairs]++;
 
-            // If vertex i dominates vertex j, we may always choose i over j since it can only ever satisfy more constraints
-            // This means we may disable j
-            if (std::includes(edgeSet.begin(), edgeSet.end(), otherEdgeSet.begin(), otherEdgeSet.end())) {
-                useVariable[j] = false;
-                reductionCount++;
+        if (liveDegree[i] < liveDegree[j]) continue; // If other vertex contains less edges, it can't dominate
+        if (liveDegree[i] == liveDegree[j] && i > j) continue; // Among identical vertices the first one is kept
+        if (profile) profile->counters[Profile::SubsetTests]++;
 
-                if (verbose) std::cout << "Vertex " << i + 1 << " dominates " << j + 1 << std::endl;
-            }
+        // If vertex i dominates vertex j, we may always choose i over j since it can only ever satisfy more constraints
+        // This means we may disable j
+        if (liveEdgesContained(j, i)) {
+            disableVariable(j);
+
+            if (verbose) std::cout << "Vertex " << i + 1 << " dominates " << j + 1 << std::endl;
+            return true;
         }
     }
-    return reductionCount;
+    return false;
 }
 
 int Hypergraph::reductionCountingRule(std::set<int>& dominatingSet, bool verbose){
-    //TODO: maybe need to turn this around? since it originates from set cover
+    ensureLiveCounts();
+    profile = Profile::current();
     int reductionCount = 0;
 
-    // Iterate over each hyperedge (potential set R)
-    for (size_t i = 0; i < hyperedges.size(); ++i) {
-        if (!useConstraint[i]) continue; // Make sure we still need to cover i
+    // Iterate over each vertex, the set R of constraints it covers is the potential set
+    for (size_t i = 0; i < vertex_to_hyperedges.size(); ++i) {
+        if (!useVariable[i]) continue;
 
-        std::set<int> R(hyperedges[i].begin(), hyperedges[i].end());
+        if (applyCountingRule(i, dominatingSet, verbose)) reductionCount++;
+    }
 
-        // Compute r2: elements in R that appear exactly twice in the hypergraph
-        std::vector<int> freqTwoElements;
-        for (int e : R) {
-            if (vertex_to_hyperedges[e].size() == 2) {
-                freqTwoElements.push_back(e);
-            }
+    return reductionCount;
+}
+
+// Counting rule from set cover, with the constraints as elements and the vertices as sets:
+// if the other sets containing frequency-two elements of R add fewer than r2 new elements, take R.
+// r2 counts distinct partner sets, so two elements sharing their partner are not counted twice.
+bool Hypergraph::applyCountingRule(int i, std::set<int>& dominatingSet, bool verbose){
+    RuleTimer timer(profile, Profile::CountingRule);
+    // Scratch markers are reused across calls, a fresh stamp invalidates all old marks at once
+    if (inR.size() != hyperedges.size() || seenPartner.size() != vertex_to_hyperedges.size()) {
+        inR.assign(hyperedges.size(), 0);
+        external.assign(hyperedges.size(), 0);
+        seenPartner.assign(vertex_to_hyperedges.size(), 0);
+        stamp = 0;
+    }
+    stamp++;
+
+    // Compute r2: partners of the elements in R that appear exactly twice
+    int r2 = 0;
+    for (int e : vertex_to_hyperedges[i]) {
+        if (!useConstraint[e]) continue;
+        inR[e] = stamp;
+    }
+    for (int e : vertex_to_hyperedges[i]) {
+        if (!useConstraint[e] || liveSize[e] != 2) continue;
+        int other = partner(e, i);
+        if (seenPartner[other] == stamp) continue;
+        seenPartner[other] = stamp;
+        r2++;
+    }
+    if (r2 == 0) return false; // No frequency-two elements, skip
+
+    // Compute q: elements in the partner sets that are not in R
+    int q = 0;
+    for (int e : vertex_to_hyperedges[i]) {
+        if (!useConstraint[e] || liveSize[e] != 2) continue;
+        int other = partner(e, i);
+
+        for (int f : vertex_to_hyperedges[other]) {
+            if (!useConstraint[f] || inR[f] == stamp || external[f] == stamp) continue;
+            external[f] = stamp;
+            if (++q >= r2) return false; // Counting Rule can no longer apply
         }
-        int r2 = freqTwoElements.size();
-        if (r2 == 0) continue; // No frequency-two elements, skip
-
-        // Compute q: elements in sets containing a frequency-two element from R but not in R
-        std::unordered_set<int> freqTwoSet(freqTwoElements.begin(), freqTwoElements.end());
-        std::set<int> externalElements;
-        for (size_t j = 0; j < hyperedges.size(); ++j) {
-            if (i == j) continue; //Skip itself
-
-            bool hasFreqTwo = false;
-            for (int v : hyperedges[j]) {
-                if (freqTwoSet.find(v) != freqTwoSet.end()) {
-                    hasFreqTwo = true;
-                    break;
-                }
+    }
+
+    // Apply Counting Rule if q < r2
+    chooseVertex(i, dominatingSet);
+
+    if (verbose) {
+        std::cout << "Reduction Counting Rule: Chose vertex " << i + 1 << " (r2 = " << r2 << ", q = " << q << ")" << std::endl;
+    }
+    return true;
+}
+
+ReductionCounts Hypergraph::reduceExhaustively(std::set<int>& dominatingSet, bool verbose){
+    ensureLiveCounts();
+    profile = Profile::current();
+    ReductionCounts counts;
+
+    // Closed-neighborhood specific rule, its precondition is structural so one pass is enough
+    counts.singleEdgeVertex = reductionSingleEdgeVertex(dominatingSet, verbose);
+
+    // Everything is dirty at the start, afterwards only what the last changes touched
+    startTracking();
+    for (size_t e = 0; e < hyperedges.size(); ++e) queueEdge(e);
+    for (size_t v = 0; v < vertex_to_hyperedges.size(); ++v) queueVertex(v);
+
+    drainWorklist(counts, dominatingSet, verbose);
+    tracking = false;
+
+    return counts;
+}
+
+void Hypergraph::startTracking(){
+    if (edgeQueued.size() != hyperedges.size() || vertexQueued.size() != vertex_to_hyperedges.size()) {
+        edgeQueued.assign(hyperedges.size(), false);
+        vertexQueued.assign(vertex_to_hyperedges.size(), false);
+    }
+    tracking = true;
+}
+
+void Hypergraph::drainWorklist(ReductionCounts& counts, std::set<int>& dominatingSet, bool verbose){
+    while (!edgeQueue.empty() || !vertexQueue.empty()) {
+        // Edge rules are cheaper and force vertices, so they run before any vertex is looked at
+        while (!edgeQueue.empty()) {
+            int e = edgeQueue.back();
+            edgeQueue.pop_back();
+            edgeQueued[e] = false;
+            if (!useConstraint[e]) continue;
+
+            // Only excluding vertices empties a hyperedge, choosing one also disables its hyperedges
+            if (liveSize[e] == 0) {
+                conflict = true;
+                return;
             }
 
-            if (!hasFreqTwo) continue; // No frequency-two element here, so ignore this hyperedge
+            if (chooseIfIsolated(e, dominatingSet, verbose)) {
+                counts.isolatedVertex++;
+                continue;
+            }
+            counts.dominatingEdge += disableSupersetsOf(e, verbose);
 
-            for (int v : hyperedges[j]) {
-                if (R.find(v) == R.end()) {
-                    externalElements.insert(v);
+            // e may have just become a frequency-two element
+            if (useConstraint[e] && liveSize[e] == 2) {
+                for (int v : hyperedges[e]) {
+                    if (useVariable[v]) queueVertex(v);
                 }
             }
         }
-        int q = externalElements.size();
 
-        // Apply Counting Rule if q < r2
-        if (q < r2) {
-            dominatingSet.insert(i);
-            
-            //useConstraint[i] = false;
-            useVariable[i] = false;
+        if (!vertexQueue.empty()) {
+            int v = vertexQueue.back();
+            vertexQueue.pop_back();
+            vertexQueued[v] = false;
+            if (!useVariable[v]) continue;
 
-            for (auto& j : hyperedges[i]){
-                useConstraint[j] = false;
+            if (disableIfDominated(v, verbose)) {
+                counts.dominatingVertex++;
+            } else if (applyCountingRule(v, dominatingSet, verbose)) {
+                counts.countingRule++;
             }
+        }
+    }
+}
 
-            reductionCount++;
+void Hypergraph::selectVertex(int v, std::set<int>& dominatingSet){
+    ensureLiveCounts();
+    startTracking();
+    chooseVertex(v, dominatingSet);
+}
+
+void Hypergraph::excludeVertex(int v){
+    ensureLiveCounts();
+    startTracking();
+    if (useVariable[v]) disableVariable(v);
+}
+
+ReductionCounts Hypergraph::propagate(std::set<int>& dominatingSet, bool verbose){
+    ensureLiveCounts();
+    profile = Profile::current();
+    startTracking();
+    ReductionCounts counts;
+    drainWorklist(counts, dominatingSet, verbose);
+    return counts;
+}
+
+size_t Hypergraph::checkpoint(){
+    ensureLiveCounts();
+    trailing = true;
+    return trail.size();
+}
+
+void Hypergraph::restoreCheckpoint(size_t mark, std::set<int>& dominatingSet){
+    while (trail.size() > mark) {
+        TrailEntry entry = trail.back();
+        trail.pop_back();
+
+        // Exact inverse of disableVariable and disableConstraint, so the live counts stay valid
+        if (entry.kind == TrailEntry::Variable) {
+            useVariable[entry.index] = true;
+            for (int e : vertex_to_hyperedges[entry.index]) liveSize[e]++;
+        } else if (entry.kind == TrailEntry::Constraint) {
+            useConstraint[entry.index] = true;
+            for (int u : hyperedges[entry.index]) liveDegree[u]++;
+        } else {
+            dominatingSet.erase(entry.index);
+        }
+    }
 
-            if (verbose) {
-                std::cout << "Reduction Counting Rule: Removed hyperedge " << i + 1 << " (r2 = " << r2 << ", q = " << q << ")" << std::endl;
+    // The worklist of an abandoned propagation is dropped
+    for (int e : edgeQueue) edgeQueued[e] = false;
+    for (int v : vertexQueue) vertexQueued[v] = false;
+    edgeQueue.clear();
+    vertexQueue.clear();
+    conflict = false;
+}
+
+// For callers that track chosen vertices themselves
+void Hypergraph::restoreCheckpoint(size_t mark){
+    std::set<int> ignored;
+    restoreCheckpoint(mark, ignored);
+}
+
+// Keeps the current state and stops recording
+void Hypergraph::releaseTrail(){
+    trailing = false;
+    trail.clear();
+}
+
+// Classic greedy on the active part: repeatedly take the usable vertex covering most uncovered
+// active hyperedges. Degrees are counted here, so it works whether or not anything was reduced.
+std::vector<int> Hypergraph::greedyHittingSet() const{
+    int n = vertex_to_hyperedges.size();
+    int m = hyperedges.size();
+
+    std::vector<bool> covered(m);
+    std::vector<int> gain(n, 0);
+    for (int e = 0; e < m; ++e) {
+        covered[e] = !useConstraint[e];
+        if (covered[e]) continue;
+        for (int v : hyperedges[e]) {
+            if (useVariable[v]) gain[v]++;
+        }
+    }
+
+    std::priority_queue<std::pair<int, int>> queue; // (gain, -vertex), stale entries are skipped
+    for (int v = 0; v < n; ++v) {
+        if (gain[v] > 0) queue.push({gain[v], -v});
+    }
+
+    std::vector<int> solution;
+    while (!queue.empty()) {
+        auto [g, negV] = queue.top();
+        queue.pop();
+        int v = -negV;
+        if (g != gain[v]) {
+            if (gain[v] > 0) queue.push({gain[v], -v});
+            continue;
+        }
+
+        solution.push_back(v);
+        for (int e : vertex_to_hyperedges[v]) {
+            if (covered[e]) continue;
+            covered[e] = true;
+            for (int u : hyperedges[e]) {
+                if (useVariable[u]) gain[u]--;
             }
         }
     }
+    return solution;
+}
 
-    return reductionCount;
+// Splits the active part into independent instances, found by an iterative search over
+// hyperedges and the usable vertices connecting them. Component c is parts[c], whose vertex i is
+// vertex vertexMaps[c][i] of this hypergraph. Usable vertices in no active hyperedge are dropped.
+std::pair<std::vector<Hypergraph>, std::vector<std::vector<int>>> Hypergraph::splitComponents() const{
+    int n = vertex_to_hyperedges.size();
+    int m = hyperedges.size();
+
+    // Component and index inside it, for hyperedges and vertices alike
+    std::vector<int> edgeComponent(m, -1), edgeIndex(m, -1);
+    std::vector<int> vertexComponent(n, -1), vertexIndex(n, -1);
+    std::vector<std::vector<int>> vertexMaps;
+    std::vector<std::vector<int>> edgeSizes;
+
+    std::vector<int> stack;
+    for (int start = 0; start < m; ++start) {
+        if (!useConstraint[start] || edgeComponent[start] != -1) continue;
+
+        int c = vertexMaps.size();
+        vertexMaps.emplace_back();
+        edgeSizes.emplace_back();
+
+        edgeComponent[start] = c;
+        stack.push_back(start);
+        while (!stack.empty()) {
+            int e = stack.back();
+            stack.pop_back();
+            edgeIndex[e] = edgeSizes[c].size();
+            edgeSizes[c].push_back(0);
+
+            for (int v : hyperedges[e]) {
+                if (!useVariable[v]) continue;
+                edgeSizes[c].back()++;
+                if (vertexComponent[v] != -1) continue;
+
+                vertexComponent[v] = c;
+                vertexIndex[v] = vertexMaps[c].size();
+                vertexMaps[c].push_back(v);
+                for (int f : vertex_to_hyperedges[v]) {
+                    if (!useConstraint[f] || edgeComponent[f] != -1) continue;
+                    edgeComponent[f] = c;
+                    stack.push_back(f);
+                }
+            }
+        }
+    }
+
+    std::vector<Hypergraph> parts;
+    parts.reserve(vertexMaps.size());
+    for (size_t c = 0; c < vertexMaps.size(); ++c) {
+        parts.emplace_back(edgeSizes[c].size(), edgeSizes[c].size(), vertexMaps[c].size());
+        parts.back().reserveHyperedges(edgeSizes[c]);
+    }
+    for (int e = 0; e < m; ++e) {
+        if (edgeComponent[e] == -1) continue;
+        for (int v : hyperedges[e]) {
+            if (useVariable[v]) parts[edgeComponent[e]].addVertexToHyperedge(edgeIndex[e], vertexIndex[v]);
+        }
+    }
+    for (auto& part : parts) part.setVertexToHyperedges();
+
+    return std::make_pair(std::move(parts), std::move(vertexMaps));
 }
 
 
-void Hypergraph::writeHittingSetLP(const std::string &outputFile, bool ILP) const{
+void Hypergraph::writeHittingSetLP(const std::string &outputFile, bool ILP, int threads) const{
     std::ofstream file(outputFile);
     if (!file.is_open()) {
         throw std::runtime_error("Failed to open file: " + outputFile);
     }
+    writeHittingSetLP(file, ILP, threads);
+}
+
+// Every section is written item by item through writeItems, so large models are formatted in parallel
+void Hypergraph::writeHittingSetLP(std::ostream& stream, bool ILP, int threads) const{
+    TextWriter file(stream);
+    size_t n = vertex_to_hyperedges.size();
 
     // Write the objective function
     file << "Minimize\n obj: ";
-    bool first = true;
-    for (size_t i = 0; i < vertex_to_hyperedges.size(); ++i) {
-        if (!useVariable[i]) continue; // Skip disallowed variables
+    size_t first = 0;
+    while (first < n && !useVariable[first]) first++;
+    writeItems(file, n, threads, [&](TextWriter& out, size_t i) {
+        if (!useVariable[i]) return; // Skip disallowed variables
 
-        if (!first) {
-            file << " + ";
+        if (i != first) {
+            out << " + ";
         }
-        file << "x" << i + 1;
-        first = false;
-    }
+        out << 'x' << i + 1;
+    });
     file << "\n\nSubject To\n";
 
-    // Write the constraints (one per closed neighborhood)
-    for (size_t i = 0; i < hyperedges.size(); ++i) {
-        if (!useConstraint[i]) continue; // Skip inactive constraints
+    // Write the constraints (one per closed neighborhood), rows are sorted and free of duplicates
+    writeItems(file, hyperedges.size(), threads, [&](TextWriter& out, size_t i) {
+        if (!useConstraint[i]) return; // Skip inactive constraints
 
-        std::set<int> coveredVertices(hyperedges[i].begin(), hyperedges[i].end());
+        // Only write the constraint if there is at least one valid variable
+        auto edge = hyperedges[i];
+        if (std::none_of(edge.begin(), edge.end(), [&](int v) {return useVariable[v];})) return;
 
+        out << " c" << i + 1 << ": ";
         int count = 0;
-        std::stringstream constraintStream;
-        
-        for (int v : coveredVertices) {
+        for (int v : edge) {
             if (!useVariable[v]) continue; // Skip disallowed variables
 
             if (count > 0) {
-                constraintStream << " + ";
+                out << " + ";
             }
-            constraintStream << "x" << v + 1;
+            out << 'x' << v + 1;
             count++;
         }
-
-        // Only write the constraint if there is at least one valid variable
-        if (count > 0) {
-            file << " c" << i + 1 << ": " << constraintStream.str() << " >= 1\n";
-        }
-    }
+        out << " >= 1\n";
+    });
 
     // Write bounds and variable types
     file << "\nBounds\n";
-    for (size_t i = 0; i < vertex_to_hyperedges.size(); ++i) {
-        if (!useVariable[i]) continue; // Skip disallowed variables
-        file << " 0 <= x" << i + 1 << " <= 1\n";
-    }
+    writeItems(file, n, threads, [&](TextWriter& out, size_t i) {
+        if (!useVariable[i]) return; // Skip disallowed variables
+        out << " 0 <= x" << i + 1 << " <= 1\n";
+    });
 
     if (ILP){
         file << "\nBinary\n";
-        for (size_t i = 0; i < vertex_to_hyperedges.size(); ++i) {
-            if (!useVariable[i]) continue; // Skip disallowed variables
-            file << " x" << i + 1 << "\n";
-        }
+        writeItems(file, n, threads, [&](TextWriter& out, size_t i) {
+            if (!useVariable[i]) return; // Skip disallowed variables
+            out << " x" << i + 1 << '\n';
+        });
     }
     
 
     file << "End\n";
-    file.close();
-
 }
 
-//FUNCTION IS OUTDATED!!!
-void Hypergraph::hypergraphToSAT(const std::string& outputFile) const{
+void Hypergraph::hypergraphToSAT(const std::string& outputFile, int threads) const{
     std::ofstream file(outputFile);
     if (!file.is_open()) {
         throw std::runtime_error("Could not open the output file!");
     }
+    hypergraphToSAT(file, threads);
+}
+
+// Set cover format of DomSAT and NuSC: the usable vertices are the sets, the active hyperedges the
+// elements ("variables") that still need to be covered
+void Hypergraph::hypergraphToSAT(std::ostream& stream, int threads) const{
+    TextWriter file(stream);
 
-    std::vector<int> activeSetIndices(hyperedges.size(), -1);
-    std::unordered_map<int, int> setReindexMap;
-    
     // What we may pick after reductions (ignore disallowed)
     int setNum = 0;
-    for (size_t i = 0; i < hyperedges.size(); ++i) {
-        if (useVariable[i]) {       //Need to swap variable and sets when going from dominating set to set cover problem
-            activeSetIndices[i] = setNum;
-            setReindexMap[i] = setNum++;
-        }
+    std::vector<int> setIndex(vertex_to_hyperedges.size(), -1);
+    for (size_t v = 0; v < vertex_to_hyperedges.size(); ++v) {
+        if (useVariable[v]) setIndex[v] = setNum++;
     }
 
     // What still needs to be covered after reductions
     int varNum = 0;
-    std::vector<int> activeVarIndices(useVariable.size(), -1);
-    for (size_t i = 0; i < useVariable.size(); ++i) {
-        if (useConstraint[i]) {
-            activeVarIndices[i] = varNum++;
-        }
+    for (size_t e = 0; e < hyperedges.size(); ++e) {
+        if (useConstraint[e]) varNum++;
     }
-    
-    //std::cout << varNum << " " << setNum << std::endl;
-    //std::cout << std::endl;
-    //for (auto var : activeVarIndices){
-    //    std::cout << var << std::endl;
-    //}
-    //std::cout << std::endl;
-    //for (auto var : activeSetIndices){
-    //    std::cout << var << std::endl;
-    //}
 
     // Print variable count and set count
-    file << varNum << " " << setNum << "\n";
+    file << varNum << ' ' << setNum << '\n';
 
     // Print set weights  =1 for all sets
     for (int i = 0; i < setNum; ++i) {
         file << "1 ";
     }
-    file << "\n";
-    
+    file << '\n';
+
     // Print variable-to-set mapping
-    for (size_t i = 0; i < useConstraint.size(); ++i) {
-        if (!useConstraint[i]) continue; //Skip if this variable is already being covered by a set via previous reductions
-        
-        int varIndex = activeVarIndices[i];
-        std::vector<int> coveredSets;
-        
-        for (auto elem : hyperedges[i]) {
-            if (useVariable[elem]) {
-                coveredSets.push_back(setReindexMap[elem]);
-            }
-        }
-        if (useVariable[i]){
-            coveredSets.push_back(setReindexMap[i]); //variable itself contained
+    writeItems(file, hyperedges.size(), threads, [&](TextWriter& out, size_t e) {
+        if (!useConstraint[e]) return; //Skip if this variable is already being covered by a set via previous reductions
+
+        // Print number of sets covering this variable, then the sets themselves
+        int count = 0;
+        for (int v : hyperedges[e]) {
+            if (useVariable[v]) count++;
         }
-        
-        // Print number of sets covering this variable
-        file << coveredSets.size() << " ";
-        
-        // Print the actual list of sets
-        for (int setID : coveredSets) {
-            file << setID+1 << " ";
+        out << count << ' ';
+        for (int v : hyperedges[e]) {
+            if (useVariable[v]) out << setIndex[v] + 1 << ' ';
         }
-        file << "\n";
-    }
-
-    file.close();
+        out << '\n';
+    });
 }
 
-void Hypergraph::writeMaxSAT(const std::string& outputFile) const{
+void Hypergraph::writeMaxSAT(const std::string& outputFile, int threads) const{
     std::ofstream file(outputFile);
     if (!file.is_open()) {
         throw std::runtime_error("Failed to open file: " + outputFile);
     }
+    writeMaxSAT(file, threads);
+}
 
+std::vector<int> Hypergraph::maxSATVariables() const{
+    std::vector<int> variables;
+    for (size_t v = 0; v < vertex_to_hyperedges.size(); ++v) {
+        if (!useVariable[v]) continue;
+        auto edges = vertex_to_hyperedges[v];
+        if (std::any_of(edges.begin(), edges.end(), [&](int e) {return useConstraint[e];})) variables.push_back(v);
+    }
+    return variables;
+}
+
+void Hypergraph::writeMaxSAT(std::ostream& stream, int threads) const{
+    TextWriter file(stream);
+
+    // Every usable vertex of an active hyperedge has a variable
+    std::vector<int> variables = maxSATVariables();
+    std::vector<int> variableOf(vertex_to_hyperedges.size(), 0);
+    for (size_t i = 0; i < variables.size(); ++i) variableOf[variables[i]] = i + 1;
 
     // Write hard clauses (one per edge)
-    for (size_t i = 0; i < hyperedges.size(); ++i) {
+    writeItems(file, hyperedges.size(), threads, [&](TextWriter& out, size_t i) {
         //there needs to be at least one active variable after h, otherwise unsatisfiable
-        if (!useConstraint[i]) continue; // Skip inactive constraints
+        if (!useConstraint[i]) return; // Skip inactive constraints
             
-        file << "h";
+        out << 'h';
         for (int neighbor : hyperedges[i]){ //include neighbors
             if (!useVariable[neighbor]) continue; // Skip disallowed variables
-            file << " " << neighbor+1;
+            out << ' ' << variableOf[neighbor];
         }
-        file << " 0\n";
-    }
+        out << " 0\n";
+    });
 
-    // Write soft clauses (one per vertex)
-    for (size_t i = 0; i < hyperedges.size(); ++i) {
-        //if (!useVariable[i]) continue; // Skip already satisfied vertices
-        file << "1 -" << i+1 << " 0\n";
-    }
-
-    file.close();
-}
\ No newline at end of file
+    // Write soft clauses (one per variable)
+    writeItems(file, variables.size(), threads, [&](TextWriter& out, size_t i) {
+        out << "1 -" << i+1 << " 0\n";
+    });
+}
@@ -9,18 +9,84 @@
 #include <unordered_map>
 #include <sstream>
 #include <unordered_set>
+#include <queue>
+
+#include "csr.h"
+#include "profile.h"
+
+// How often each reduction rule fired
+struct ReductionCounts {
+    int isolatedVertex = 0;
+    int singleEdgeVertex = 0;
+    int dominatingEdge = 0;
+    int dominatingVertex = 0;
+    int countingRule = 0;
+};
+
+// One undoable change, recorded on the trail while a checkpoint is open
+struct TrailEntry {
+    enum Kind : char {Constraint, Variable, Chosen};
+    Kind kind;
+    int index;      // Hyperedge, or vertex for Variable and Chosen
+};
 
 class Hypergraph {
 private:
-    std::vector<std::vector<int>> hyperedges;
-    std::vector<std::vector<int>> vertex_to_hyperedges;
+    CSR hyperedges;             // Vertices of every hyperedge
+    CSR vertex_to_hyperedges;   // Hyperedges every vertex is part of
     std::vector<bool> useConstraint; // false means this constraint is irrelevant by now
     std::vector<bool> useVariable; // false means this variable isn't needed in at least one optimal solution
 
+    // Number of usable vertices per hyperedge and of active hyperedges per vertex
+    std::vector<int> liveSize;
+    std::vector<int> liveDegree;
+
+    // Worklist of reduceExhaustively and propagate, only filled while tracking is set
+    bool tracking = false;
+    bool conflict = false;      // propagate() met an active hyperedge without usable vertices
+    std::vector<int> edgeQueue;
+    std::vector<int> vertexQueue;
+    std::vector<bool> edgeQueued;
+    std::vector<bool> vertexQueued;
+
+    // Flag flips and solution insertions since the first open checkpoint, undone in reverse
+    bool trailing = false;
+    std::vector<TrailEntry> trail;
+
+    // Scratch space of the counting rule, entries equal to stamp belong to the current set
+    std::vector<unsigned> inR;
+    std::vector<unsigned> external;
+    std::vector<unsigned> seenPartner;
+    unsigned stamp = 0;
+
+    // Profile of the thread running the rules, picked up by every public reduction entry point
+    Profile* profile = nullptr;
+
+    void initLiveCounts();
+    void ensureLiveCounts();
+    void queueEdge(int edge);
+    void queueVertex(int vertex);
+    void startTracking();
+    void drainWorklist(ReductionCounts& counts, std::set<int>& dominatingSet, bool verbose);
+    int partner(int edge, int vertex) const;
+    void disableVariable(int vertex);
+    void disableConstraint(int edge);
+    void chooseVertex(int vertex, std::set<int>& dominatingSet);
+
+    bool liveVerticesContained(int edge, int other) const;
+    bool liveEdgesContained(int vertex, int other) const;
+    bool chooseIfIsolated(int edge, std::set<int>& dominatingSet, bool verbose);
+    int disableSupersetsOf(int edge, bool verbose);
+    bool disableIfDominated(int vertex, bool verbose);
+    bool applyCountingRule(int vertex, std::set<int>& dominatingSet, bool verbose);
+
 public:
     Hypergraph(int num_hyperedges, int num_constraints, int num_variables);
+    Hypergraph(CSR hyperedges, CSR vertex_to_hyperedges, std::vector<bool> useConstraint, std::vector<bool> useVariable);
+    void reserveHyperedges(const std::vector<int>& sizes);
     void initEdge(int vertices);
     void addEdge(int u, int v);
+    void addVertexToHyperedge(int edge, int vertex);
     void setVertexToHyperedges();
     void setHyperedges(const std::vector<std::vector<int>>& sets);
     void setVertexToHyperedges(const std::vector<std::vector<int>>& part_of);
@@ -31,9 +97,45 @@ public:
     int reductionDominatingEdge(std::set<int>& dominatingSet, bool verbose);
     int reductionDominatingVertex(std::set<int>& dominatingSet, bool verbose);
     int reductionCountingRule(std::set<int>& dominatingSet, bool verbose);
+    ReductionCounts reduceExhaustively(std::set<int>& dominatingSet, bool verbose);
+    std::vector<int> greedyHittingSet() const;
+    std::pair<std::vector<Hypergraph>, std::vector<std::vector<int>>> splitComponents() const;
+
+    // Search interface: decisions keep the live counts current and queue what they touched,
+    // propagate() then runs the set cover rules on the queued part only
+    void selectVertex(int vertex, std::set<int>& dominatingSet);
+    void excludeVertex(int vertex);
+    ReductionCounts propagate(std::set<int>& dominatingSet, bool verbose);
+    bool hasConflict() const {return conflict;};
+
+    // Trail interface: after checkpoint() every change is recorded, and restoreCheckpoint() undoes
+    // everything after the returned mark in time proportional to the changes. Chosen vertices are
+    // erased from the given set, which has to be the one the reductions inserted them into.
+    size_t checkpoint();
+    void restoreCheckpoint(size_t mark, std::set<int>& dominatingSet);
+    void restoreCheckpoint(size_t mark);
+    void releaseTrail();
+
+    int numHyperedges() const {return hyperedges.size();};
+    int numVertices() const {return vertex_to_hyperedges.size();};
+    bool isActive(int edge) const {return useConstraint[edge];};
+    bool isUsable(int vertex) const {return useVariable[vertex];};
+    int getLiveSize(int edge) const {return liveSize[edge];};
+    int getLiveDegree(int vertex) const {return liveDegree[vertex];};
+    RowView<const int> verticesOf(int edge) const {return hyperedges[edge];};
+    RowView<const int> edgesOf(int vertex) const {return vertex_to_hyperedges[vertex];};
+    const CSR& hyperedgeRows() const {return hyperedges;};
+    const CSR& incidenceRows() const {return vertex_to_hyperedges;};
 
-    void writeHittingSetLP(const std::string &outputFile, bool ILP) const;
-    void hypergraphToSAT(const std::string& outputFile) const;
-    void writeMaxSAT(const std::string& outputFile) const;
+    // Model exports, formatted on threads threads (<= 0 uses all); the output does not depend on it
+    void writeHittingSetLP(const std::string &outputFile, bool ILP, int threads = 1) const;
+    void writeHittingSetLP(std::ostream& file, bool ILP, int threads = 1) const;
+    void hypergraphToSAT(const std::string& outputFile, int threads = 1) const;
+    void hypergraphToSAT(std::ostream& file, int threads = 1) const;
+    // MaxSAT only has variables for usable vertices in an active hyperedge, numbered densely:
+    // variable i+1 is vertex maxSATVariables()[i]
+    std::vector<int> maxSATVariables() const;
+    void writeMaxSAT(const std::string& outputFile, int threads = 1) const;
+    void writeMaxSAT(std::ostream& file, int threads = 1) const;
 };
 #endif // HYPERGRAPH2_H
@@ -0,0 +1,284 @@
+#include "localsearch.h"
+
+#include <chrono>
+#include <stdexcept>
+#include <algorithm>
+
+LocalSearch::LocalSearch(const Hypergraph& hypergraph, const LocalSearchOptions& options) : options(options) {
+    int n = hypergraph.numVertices();
+    int m = hypergraph.numHyperedges();
+
+    // Active hyperedges become the elements and the usable vertices in them the sets.
+    // Sizes are counted here, the hypergraph's live counts may not exist yet if nothing was reduced
+    std::vector<int> activeEdges;
+    std::vector<int> elementSizes;
+    std::vector<int> degree(n, 0);
+    for (int e = 0; e < m; ++e) {
+        if (!hypergraph.isActive(e)) continue;
+
+        int size = 0;
+        for (int v : hypergraph.verticesOf(e)) {
+            if (!hypergraph.isUsable(v)) continue;
+            degree[v]++;
+            size++;
+        }
+        if (size == 0) {
+            throw std::runtime_error("Instance has a hyperedge that no vertex can cover");
+        }
+        activeEdges.push_back(e);
+        elementSizes.push_back(size);
+    }
+
+    localId.assign(n, -1);
+    std::vector<int> setSizes;
+    for (int v = 0; v < n; ++v) {
+        if (degree[v] == 0) continue; // Unusable or covers nothing that is left
+        localId[v] = original.size();
+        original.push_back(v);
+        setSizes.push_back(degree[v]);
+    }
+
+    setsOf.setRowSizes(elementSizes);
+    elementsOf.setRowSizes(setSizes);
+    for (size_t element = 0; element < activeEdges.size(); ++element) {
+        for (int v : hypergraph.verticesOf(activeEdges[element])) {
+            if (!hypergraph.isUsable(v)) continue;
+            setsOf.append(element, localId[v]);
+            elementsOf.append(localId[v], element);
+        }
+    }
+}
+
+void LocalSearch::markUncovered(int element){
+    uncoveredPos[element] = uncovered.size();
+    uncovered.push_back(element);
+}
+
+void LocalSearch::markCovered(int element){
+    int last = uncovered.back();
+    uncovered[uncoveredPos[element]] = last;
+    uncoveredPos[last] = uncoveredPos[element];
+    uncovered.pop_back();
+}
+
+// The solution set other than set covering element, only meaningful if it is covered exactly once more
+int LocalSearch::solutionPartner(int element, int set) const{
+    for (int other : setsOf[element]) {
+        if (other != set && inSolution[other]) return other;
+    }
+    return -1;
+}
+
+void LocalSearch::addSet(int set, long long step){
+    inSolution[set] = true;
+    solutionPos[set] = solution.size();
+    solution.push_back(set);
+    age[set] = step;
+
+    long long newScore = 0;
+    for (int e : elementsOf[set]) {
+        covered[e]++;
+        if (covered[e] == 1) {
+            // Nobody else gains e anymore, and set alone loses it when removed
+            markCovered(e);
+            for (int other : setsOf[e]) {
+                if (other == set) continue;
+                score[other] -= weight[e];
+                confChanged[other] = true;
+            }
+            newScore -= weight[e];
+        } else if (covered[e] == 2) {
+            score[solutionPartner(e, set)] += weight[e]; // No longer the only one covering e
+        }
+    }
+    score[set] = newScore;
+}
+
+void LocalSearch::removeSet(int set, long long step){
+    inSolution[set] = false;
+    int last = solution.back();
+    solution[solutionPos[set]] = last;
+    solutionPos[last] = solutionPos[set];
+    solution.pop_back();
+    age[set] = step;
+    confChanged[set] = false;
+
+    long long newScore = 0;
+    for (int e : elementsOf[set]) {
+        covered[e]--;
+        if (covered[e] == 0) {
+            markUncovered(e);
+            for (int other : setsOf[e]) {
+                if (other == set) continue;
+                score[other] += weight[e];
+                confChanged[other] = true;
+            }
+            newScore += weight[e];
+        } else if (covered[e] == 1) {
+            score[solutionPartner(e, set)] -= weight[e]; // The remaining set is now the only one
+        }
+    }
+    score[set] = newScore;
+}
+
+// Starts from the given vertices and completes them greedily. All weights are still one, so the
+// score of a set outside the solution is its number of uncovered elements; sets sit in a bucket
+// per score and are moved down lazily when they turn out to have lost elements.
+void LocalSearch::construct(const std::vector<int>& initial){
+    for (int v : initial) {
+        if (v < 0 || v >= static_cast<int>(localId.size())) continue;
+        int set = localId[v];
+        if (set >= 0 && !inSolution[set]) addSet(set, 0);
+    }
+
+    int maxScore = 0;
+    for (size_t set = 0; set < original.size(); ++set) {
+        if (!inSolution[set]) maxScore = std::max<long long>(maxScore, score[set]);
+    }
+    std::vector<std::vector<int>> buckets(maxScore + 1);
+    for (size_t set = 0; set < original.size(); ++set) {
+        if (!inSolution[set] && score[set] > 0) buckets[score[set]].push_back(set);
+    }
+
+    for (int g = maxScore; g > 0 && !uncovered.empty(); --g) {
+        while (!buckets[g].empty()) {
+            int set = buckets[g].back();
+            buckets[g].pop_back();
+            if (inSolution[set]) continue;
+            if (score[set] != g) {
+                if (score[set] > 0) buckets[score[set]].push_back(set);
+                continue;
+            }
+            addSet(set, 0);
+        }
+    }
+}
+
+void LocalSearch::removeRedundant(){
+    std::vector<int> current = solution;
+    for (int set : current) {
+        if (score[set] == 0) removeSet(set, 0); // Covers nothing on its own
+    }
+}
+
+// Best of a few random solution sets: the one losing the least weight, older ones first on ties
+int LocalSearch::sampleRemoval(int tabu){
+    int best = -1;
+    auto better = [&](int set) {
+        if (set == tabu) return false;
+        if (best == -1) return true;
+        if (score[set] != score[best]) return score[set] > score[best];
+        return age[set] < age[best];
+    };
+
+    if (static_cast<int>(solution.size()) <= options.sampleSize) {
+        for (int set : solution) {
+            if (better(set)) best = set;
+        }
+    } else {
+        std::uniform_int_distribution<int> pick(0, solution.size() - 1);
+        for (int i = 0; i < options.sampleSize; ++i) {
+            int set = solution[pick(rng)];
+            if (better(set)) best = set;
+        }
+    }
+    return best == -1 ? tabu : best;
+}
+
+// Highest scoring set covering element that passes configuration checking; the set removed
+// in this very step only comes back if nothing else covers element
+int LocalSearch::chooseAddition(int element, int tabu) const{
+    int best = -1;
+    int fallback = -1;
+    for (int set : setsOf[element]) {
+        if (set == tabu) continue;
+        if (fallback == -1 || score[set] > score[fallback] || (score[set] == score[fallback] && age[set] < age[fallback])) fallback = set;
+        if (!confChanged[set]) continue;
+        if (best == -1 || score[set] > score[best] || (score[set] == score[best] && age[set] < age[best])) best = set;
+    }
+    if (best != -1) return best;
+    return fallback != -1 ? fallback : tabu;
+}
+
+// Elements that stay uncovered get heavier, which makes the sets covering them more attractive
+void LocalSearch::increaseWeights(){
+    for (int e : uncovered) {
+        weight[e]++;
+        for (int set : setsOf[e]) score[set]++;
+    }
+}
+
+LocalSearchResult LocalSearch::run(const std::vector<int>& initial){
+    auto start = std::chrono::steady_clock::now();
+    auto elapsed = [&]() {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    int sets = original.size();
+    int elements = setsOf.size();
+    rng.seed(options.seed);
+    weight.assign(elements, 1);
+    covered.assign(elements, 0);
+    score.assign(sets, 0);
+    inSolution.assign(sets, false);
+    confChanged.assign(sets, true);
+    age.assign(sets, 0);
+    uncovered.clear();
+    uncoveredPos.assign(elements, -1);
+    solution.clear();
+    solutionPos.assign(sets, -1);
+
+    for (int e = 0; e < elements; ++e) markUncovered(e);
+    for (int set = 0; set < sets; ++set) score[set] = elementsOf.degree(set);
+
+    construct(initial);
+    removeRedundant();
+
+    LocalSearchResult result;
+    std::vector<int> best = solution;
+    auto report = [&]() {
+        result.time = elapsed();
+        if (!onImprovement) return;
+        std::vector<int> vertices;
+        for (int set : best) vertices.push_back(original[set]);
+        onImprovement(vertices, result.time);
+    };
+    report();
+
+    long long step = 1;
+    int lastAdded = -1;
+    for (; elements > 0; ++step) {
+        if (options.maxSteps > 0 && step > options.maxSteps) break;
+        if ((step & 63) == 0 && (elapsed() >= options.timeLimit || (options.stop && *options.stop))) break;
+
+        if (uncovered.empty()) {
+            if (solution.size() < best.size()) {
+                best = solution;
+                report();
+            }
+
+            // Drop a cheap set and look for a cover with one set less
+            if (solution.empty()) break; // Nothing left to improve
+            removeSet(sampleRemoval(-1), step);
+            lastAdded = -1;
+            continue;
+        }
+
+        int removed = -1;
+        if (!solution.empty()) {
+            removed = sampleRemoval(lastAdded);
+            removeSet(removed, step);
+        }
+
+        int element = uncovered[std::uniform_int_distribution<int>(0, uncovered.size() - 1)(rng)];
+        lastAdded = chooseAddition(element, removed);
+        addSet(lastAdded, step);
+
+        increaseWeights();
+    }
+
+    result.steps = step - 1;
+    for (int set : best) result.solution.push_back(original[set]);
+    std::sort(result.solution.begin(), result.solution.end());
+    return result;
+}
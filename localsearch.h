@@ -0,0 +1,81 @@
+#ifndef LOCALSEARCH_H
+#define LOCALSEARCH_H
+
+#include <vector>
+#include <functional>
+#include <random>
+#include <atomic>
+
+#include "hypergraph2.h"
+
+struct LocalSearchOptions {
+    double timeLimit = 10;      // Seconds
+    unsigned seed = 1;
+    long long maxSteps = 0;     // 0 means only the time limit stops the search
+    int sampleSize = 50;        // Candidates drawn for every removal
+    const std::atomic<bool>* stop = nullptr; // Ends the search like the time limit
+};
+
+struct LocalSearchResult {
+    std::vector<int> solution;  // Sorted, 0-based; covers every hyperedge active at the start
+    double time = 0;            // When the returned solution was found
+    long long steps = 0;
+};
+
+// Called with every improving solution and the time it was found at
+using ImprovementCallback = std::function<void(const std::vector<int>& solution, double time)>;
+
+// Weighted local search for the hitting set left in a Hypergraph, in the spirit of NuSC:
+// hyperedges are elements with weights that grow while they stay uncovered, vertices are the
+// sets. Every step removes a sampled solution vertex that loses the least weight, then covers
+// a random uncovered hyperedge with its best vertex that passes configuration checking.
+// The instance is copied into compact arrays, so the hypergraph is only read during construction.
+class LocalSearch {
+private:
+    // Residual instance, renumbered: sets are the usable vertices, elements the active hyperedges
+    CSR elementsOf;             // Elements covered by each set
+    CSR setsOf;                 // Sets covering each element
+    std::vector<int> original;  // Original vertex of each set
+    std::vector<int> localId;   // Set of each original vertex, -1 if not usable
+
+    LocalSearchOptions options;
+    std::mt19937 rng;
+
+    std::vector<long long> weight;
+    std::vector<long long> score; // Weight gained by adding a set, minus the weight lost by removing it
+    std::vector<int> covered;     // Number of solution sets covering each element
+    std::vector<bool> inSolution;
+    std::vector<bool> confChanged; // Configuration checking: set may only enter if its neighbourhood changed
+    std::vector<long long> age;    // Step of the last change of each set
+
+    // Index-tracked members, so adding, removing and random picks are O(1)
+    std::vector<int> uncovered;
+    std::vector<int> uncoveredPos;
+    std::vector<int> solution;
+    std::vector<int> solutionPos;
+
+    ImprovementCallback onImprovement;
+
+    void addSet(int set, long long step);
+    void removeSet(int set, long long step);
+    void markUncovered(int element);
+    void markCovered(int element);
+    int solutionPartner(int element, int set) const;
+
+    void construct(const std::vector<int>& initial);
+    void removeRedundant();
+    int sampleRemoval(int tabu);
+    int chooseAddition(int element, int tabu) const;
+    void increaseWeights();
+
+public:
+    LocalSearch(const Hypergraph& hypergraph, const LocalSearchOptions& options = LocalSearchOptions());
+
+    void setCallback(ImprovementCallback callback) {onImprovement = std::move(callback);};
+
+    // initial holds original vertices to start from, e.g. a greedy or partial solution; it is
+    // completed greedily and stripped of redundant vertices before the search starts
+    LocalSearchResult run(const std::vector<int>& initial = std::vector<int>());
+};
+
+#endif // LOCALSEARCH_H
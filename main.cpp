@@ -1,687 +1,274 @@
 #include <iostream>
-#include <memory>
 #include <stdexcept>
-#include <array>
-#include <fstream>
+#include <string>
+#include <vector>
+#include <set>
 #include <sstream>
-#include <dirent.h>
-#include <cmath>
-#include <regex>
-#include <chrono>
+#include <filesystem>
 
 #include "graph.h"
 #include "hypergraph2.h"
+#include "parser.h"
+#include "solvers.h"
+#include "batch.h"
+#include "snapshot.h"
+#include "generators.h"
 
-std::string exec(const std::string& command) {
-    std::array<char, 128> buffer;
-    std::string result;
-    
-    // Define the correct type for the deleter
-    auto pclose_deleter = [](FILE* f) { pclose(f); };
-
-    // Open a pipe to run the command
-    std::unique_ptr<FILE, decltype(pclose_deleter)> pipe(popen(command.c_str(), "r"), pclose_deleter);
-    
-    if (!pipe) {
-        throw std::runtime_error("popen() failed!");
-    }
-    
-    // Read the output into the result string
-    while (fgets(buffer.data(), buffer.size(), pipe.get()) != nullptr) {
-        result += buffer.data();
-    }
-    
-    return result;
-}
-
-std::vector<int> readJsonArray(const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        throw std::runtime_error("Could not open the file!");
-    }
-
-    std::string line;
-    std::getline(file, line); 
-    file.close();
-
-    // Check for surrounding brackets
-    if (line.front() != '[' || line.back() != ']') {
-        throw std::runtime_error("Invalid JSON array format!");
-    }
-
-    // Remove the brackets
-    line = line.substr(1, line.size() - 2);
+using std::cout;
+using std::endl;
 
-    std::vector<int> result;
-    std::stringstream ss(line);
+// Splits "a,b,c" into its parts
+std::vector<std::string> splitList(const std::string& list){
+    std::vector<std::string> parts;
+    std::stringstream ss(list);
     std::string item;
-
-    // Parse each element separated by commas
     while (std::getline(ss, item, ',')) {
-        try {
-            result.push_back(std::stoi(item));
-        } catch (const std::invalid_argument& e) {
-            throw std::runtime_error("Invalid number in JSON array!");
-        }
+        if (!item.empty()) parts.push_back(item);
     }
-
-    return result;
+    return parts;
 }
 
-// Function to load a graph from a DIMACS-like .gr file format
-Graph readGraphFromFile(const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        throw std::runtime_error("Could not open the file!");
-    }
-
-    int vertices = 0;
-    std::vector<std::pair<int, int>> edges;
-
-    std::string line;
-    while (std::getline(file, line)) {
-        if (line.empty() || line[0] == 'c') {
-            continue; // Skip comments and empty lines
-        }
-
-        std::stringstream ss(line);
-        if (line[0] == 'p') {
-            std::string descriptor;
-            int numEdges;
-            ss >> descriptor >> descriptor >> vertices >> numEdges;
-            edges.reserve(numEdges); // Reserve space for edges based on the number of edges specified
-        } else {
-            int u, v;
-            ss >> u >> v;
-            edges.emplace_back(u, v);
-        }
-    }
-
-    file.close();
-
-    // Initialize the graph with the specified number of vertices and add edges
-    Graph graph(vertices);
-    for (const auto& edge : edges) {
-        graph.addEdge(edge.first, edge.second);
-    }
-
-    return graph;
+// Name of an instance directory or list file, used for the default results folder
+std::string sourceName(const std::string& source){
+    std::filesystem::path path(source);
+    if (!path.has_filename()) path = path.parent_path(); // Trailing slash
+    return path.stem().string();
 }
 
-// Function to load a graph from a DIMACS-like .gr file format
-Hypergraph readHypergraphFromFile(const std::string& filename){
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        throw std::runtime_error("Could not open the file!");
-    }
-
-    std::string extension;
-    auto pos = filename.rfind('.');
-    if (pos != std::string::npos) {
-        extension = filename.substr(pos + 1);
-        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+// ./main --batch <directory|listfile> <task[,task...]> [--jobs N] [--time-limit S] [--seed S] [--reduce] [--no-stream] [--portfolio backend,...] [--components] [--threads N] [--export-threads N] [--property-threads N] [--kernel-dir DIR] [--lp-reduce] [--profile] [--output DIR]
+// Writes DIR/<task>.csv for every task, DIR defaults to results/<name of directory or list>
+int runBatchMode(int argc, char* argv[]){
+    if (argc < 4) {
+        std::cerr << "Usage: " << argv[0] << " --batch <directory|listfile> <task[,task...]> [--jobs N] [--time-limit S] [--seed S] [--reduce] [--no-stream] [--portfolio backend,...] [--components] [--threads N] [--export-threads N] [--property-threads N] [--kernel-dir DIR] [--lp-reduce] [--profile] [--output DIR]" << std::endl;
+        std::cerr << "Tasks: properties, reductions or a solver name" << std::endl;
+        return 1;
     }
 
-    std::string line;
-    if (extension == "gr"){
-        std::vector<std::pair<int, int>> edges;
-        int vertex_count = 0;
-        int edge_count = 0;
-        
-        while (std::getline(file, line)) {
-            if (line.empty() || line[0] == 'c') {
-                continue; // Skip comments and empty lines
-            }
-            
-            std::stringstream ss(line);
-            if (line[0] == 'p') {
-                std::string descriptor;
-                ss >> descriptor >> descriptor >> vertex_count >> edge_count;
-                edges.reserve(edge_count); // Reserve space for edges based on the number of edges specified
-            } else {
-                int u, v;
-                ss >> u >> v;
-                edges.emplace_back(u, v);
-            }
+    std::string source = argv[2];
+    auto tasks = splitList(argv[3]);
+    std::string outputDir = "results/" + sourceName(source);
+    BatchOptions options;
+
+    for (int i = 4; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--jobs" && hasValue) options.jobs = std::stoi(argv[++i]);
+        else if (arg == "--time-limit" && hasValue) options.solver.timeLimit = std::stoi(argv[++i]);
+        else if (arg == "--seed" && hasValue) options.solver.seed = argv[++i];
+        else if (arg == "--output" && hasValue) outputDir = argv[++i];
+        else if (arg == "--reduce") options.reduce = true;
+        else if (arg == "--lp-reduce") {
+            options.relaxation = true;
+            options.reduce = true;
         }
-
-        file.close();
-        
-        // Initialize the graph with the specified number of vertices and add edges
-        Hypergraph hypergraph(vertex_count, vertex_count, vertex_count);
-        hypergraph.initEdge(vertex_count);
-        for (const auto& edge : edges) {
-            hypergraph.addEdge(edge.first, edge.second);
+        else if (arg == "--kernel-dir" && hasValue) {
+            options.kernelDir = argv[++i];
+            options.reduce = true;
         }
-        hypergraph.setVertexToHyperedges();
-
-        return hypergraph;
-
-    } else if (extension == "hgr") {
-        std::vector<std::vector<int>> sets;
-        std::vector<std::vector<int>> part_of;
-        int vertex_count = 0;
-        int set_count = 0;
-        int count = 0;
-
-        while (std::getline(file, line)) {
-            if (line.empty() || line[0] == 'c') {
-                continue; // Skip comments and empty lines
-            }
-    
-            std::stringstream ss(line);
-            if (line[0] == 'p') {
-                std::string descriptor;
-                ss >> descriptor >> descriptor >> vertex_count >> set_count;
-                sets.reserve(set_count); // Reserve space for edges based on the number of edges specified
-                part_of.resize(vertex_count);
-            } else {
-                std::vector<int> currentSet;
-                int vertex;
-                while (ss >> vertex) {
-                    --vertex;
-                    currentSet.push_back(vertex);
-                    part_of[vertex].push_back(count);
-                }
-
-                sets.push_back(currentSet);
-                count++;
-            }
+        else if (arg == "--profile") options.profile = true;
+        else if (arg == "--no-stream") options.solver.streamModel = false;
+        else if (arg == "--portfolio" && hasValue) options.solver.portfolio = splitList(argv[++i]);
+        else if (arg == "--components") options.solver.components = true;
+        else if (arg == "--threads" && hasValue) options.solver.threads = std::stoi(argv[++i]);
+        else if (arg == "--export-threads" && hasValue) options.solver.exportThreads = std::stoi(argv[++i]);
+        else if (arg == "--property-threads" && hasValue) options.propertyThreads = std::stoi(argv[++i]);
+        else if (arg == "--verbose") options.solver.verbose = true;
+        else {
+            std::cerr << "Unknown batch option: " << arg << std::endl;
+            return 1;
         }
-
-        file.close();
-        
-        // Initialize the graph with the specified number of vertices and add edges
-        Hypergraph hypergraph(set_count, set_count, vertex_count);
-        hypergraph.setHyperedges(sets);
-        hypergraph.setVertexToHyperedges(part_of);
-
-        return hypergraph;
-    } else {
-        throw std::runtime_error("Unsupported file extension: " + extension);
-    } 
-}
-
-void outputSolution(const std::vector<int>& solution){
-    std::cout << solution.size() << std::endl;
-    for (auto elem : solution){
-        std::cout << elem + 1 << std::endl; // Return to 1-based index from 0-based
-    }
-}
-
-void generateCSVForGraphs(const std::string& folderPath, const std::string& outputCSV) {
-    DIR* dir = opendir(folderPath.c_str());
-    if (!dir) {
-        std::cerr << "Could not open directory: " << folderPath << std::endl;
-        return;
     }
 
-    struct dirent* entry;
-    std::ofstream csvFile(outputCSV);
-    if (!csvFile.is_open()) {
-        std::cerr << "Could not open output CSV file: " << outputCSV << std::endl;
-        return;
-    }
+    std::filesystem::create_directories(outputDir);
+    if (!options.kernelDir.empty()) std::filesystem::create_directories(options.kernelDir);
 
-    // Write CSV header
-    csvFile << "Name,Vertices,Edges,Density,Max Degree,Lower Bound,Upper Bound,Triangles,Average Degree,Std Dev Degree" << std::endl;
-
-    // Iterate through all files in the directory
-    while ((entry = readdir(dir)) != nullptr) {
-        std::string filename = entry->d_name;
-
-        std::regex regex("^exact_([0-9]{3})\\.gr$");  // Match "exact_XXX.gr" where XXX is a 3-digit number
-        std::smatch match;
-
-        if (!std::regex_match(filename, match, regex)) continue;
-
-        int fileNumber = std::stoi(match[1].str());
-        if (fileNumber <= 50) continue;
-
-        //if (filename != "exact_039.gr") continue;
-        std::cout << filename << std::endl;
-
-        // Only process .gr files
-        if (filename.size() >= 3 && filename.substr(filename.size() - 3) == ".gr") {
-            std::string filepath = folderPath + "/" + filename;
-            auto graph = readGraphFromFile(filepath);
-
-            //write HittingSet ILP formulation
-            //graph.writeHittingSetILP(filepath + ".lp");
-            
-            int numVertices = graph.getVertices();
-            int numEdges = graph.getEdges();
-            double density = graph.computeDensity();
-            int maxDegree = graph.getMaxDegree();
-            double lowerBound = graph.computeEfficiencyLowerBound();
-            auto greedySol = graph.greedyDominatingSet();
-            int upperBound = greedySol.size();
-            int triangles = graph.countTriangles();
-            auto [avgDegree, stdDev] = graph.computeDegreeStats();
-            
-
-            // Write the results to the CSV
-            csvFile << filename << ","
-                    << numVertices << ","
-                    << numEdges << ","
-                    << density << ","
-                    << maxDegree << ","
-                    << lowerBound << ","
-                    << upperBound << ","
-                    << triangles << ","
-                    << avgDegree << ","
-                    << stdDev << std::endl;
-        }
+    auto instances = listInstances(source);
+    for (const auto& task : tasks) {
+        runBatch(instances, task, outputDir + "/" + task + ".csv", options);
     }
-
-    closedir(dir);
-    csvFile.close();
-    std::cout << "CSV file generated: " << outputCSV << std::endl;
+    return 0;
 }
 
-void generateReductionCSV(const std::string& folderPath, const std::string& outputCSV) {
-    DIR* dir = opendir(folderPath.c_str());
-    if (!dir) {
-        std::cerr << "Could not open directory: " << folderPath << std::endl;
-        return;
-    }
-
-    struct dirent* entry;
-    std::ofstream csvFile(outputCSV);
-    if (!csvFile.is_open()) {
-        std::cerr << "Could not open output CSV file: " << outputCSV << std::endl;
-        return;
+// ./main --generate <family[,family...]> <vertices[,vertices...]> [--degree D] [--seed S] [--count K] [--format gr|hgr] [--output DIR]
+// Writes DIR/<family>_<vertices>_<seed>.<format> for every combination, K seeds from S on; DIR defaults to graphs/generated
+int runGenerateMode(int argc, char* argv[]){
+    if (argc < 4) {
+        std::cerr << "Usage: " << argv[0] << " --generate <family[,family...]> <vertices[,vertices...]> [--degree D] [--seed S] [--count K] [--format gr|hgr] [--output DIR]" << std::endl;
+        std::cerr << "Families: er, ba, geometric, grid, road" << std::endl;
+        return 1;
     }
 
-    // Write CSV header
-    csvFile << "Name,Isolated,Single Edge,Dominating Edge,Dominating Vertex,Counting Rule,Set Size,Time (s)" << std::endl;
-
-    // Iterate through all files in the directory
-    while ((entry = readdir(dir)) != nullptr) {
-        std::string filename = entry->d_name;
-
-        std::regex regex("^exact_([0-9]{3})\\.gr$");  // Match "exact_XXX.gr" where XXX is a 3-digit number
-        std::smatch match;
-
-        if (!std::regex_match(filename, match, regex)) continue;
-
-        int fileNumber = std::stoi(match[1].str());
-        //if (fileNumber <= 50) continue;
-
-        if (filename != "exact_040.gr") continue;
-        std::cout << filename << std::endl;
-
-        // Only process .gr files
-        if (filename.size() >= 3 && filename.substr(filename.size() - 3) == ".gr") {
-            std::string filepath = folderPath + "/" + filename;
-
-            auto start = std::chrono::high_resolution_clock::now();
-
-            auto hypergraph = readHypergraphFromFile(filepath);
-            
-            std::set<int> dominatingSet;
-            int isolatedVertexUsage = 0;
-            int singleEdgeVertexUsage = 0;
-            int dominatingEdgeUsage = 0;
-            int dominatingVertexUsage = 0;
-            int countingRuleUsage = 0;
-
-            isolatedVertexUsage = hypergraph.reductionIsolatedVertex(dominatingSet, false);
-            singleEdgeVertexUsage = hypergraph.reductionSingleEdgeVertex(dominatingSet, false);
-            countingRuleUsage = hypergraph.reductionCountingRule(dominatingSet, false);
-            dominatingEdgeUsage = hypergraph.reductionDominatingEdge(dominatingSet, false);
-            dominatingVertexUsage = hypergraph.reductionDominatingVertex(dominatingSet, false);     
-
-            auto end = std::chrono::high_resolution_clock::now();
-            double elapsedSec = std::chrono::duration<double>(end - start).count();  // Convert to seconds
-
-            // Write the results to the CSV
-            csvFile << filename << ","
-                    << isolatedVertexUsage << ","
-                    << singleEdgeVertexUsage << ","
-                    << dominatingEdgeUsage << ","
-                    << dominatingVertexUsage << ","
-                    << countingRuleUsage << ","
-                    << dominatingSet.size() << ","
-                    << elapsedSec << std::endl;
+    auto families = splitList(argv[2]);
+    std::vector<int> sizes;
+    for (const auto& size : splitList(argv[3])) sizes.push_back(std::stoi(size));
+    double degree = 8;
+    unsigned seed = 1;
+    int count = 1;
+    std::string format = "gr";
+    std::string outputDir = "graphs/generated";
+
+    for (int i = 4; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--degree" && hasValue) degree = std::stod(argv[++i]);
+        else if (arg == "--seed" && hasValue) seed = std::stoul(argv[++i]);
+        else if (arg == "--count" && hasValue) count = std::stoi(argv[++i]);
+        else if (arg == "--format" && hasValue) format = argv[++i];
+        else if (arg == "--output" && hasValue) outputDir = argv[++i];
+        else {
+            std::cerr << "Unknown generate option: " << arg << std::endl;
+            return 1;
         }
     }
-
-    closedir(dir);
-    csvFile.close();
-    std::cout << "CSV file generated: " << outputCSV << std::endl;
-}
-
-std::pair<double, double> parseReport(const std::string& report, const std::string& solver){
-    std::pair<double, double> result = {-1, -1}; // Default values if parsing fails
-
-    if (solver == "highs"){
-        std::regex primalBoundRegex(R"(Primal bound\s+(\d+\.?\d*))");
-        std::regex timingRegex(R"(Timing\s+([\d\.]+)\s+\(total\))");
-        
-        std::smatch match;
-
-        // Extract primal bound
-        if (std::regex_search(report, match, primalBoundRegex) && match.size() > 1) {
-            result.first = std::stod(match[1]);
+    for (const auto& family : families) {
+        if (!isGraphFamily(family)) {
+            std::cerr << "Unknown graph family: " << family << std::endl;
+            return 1;
         }
+    }
+    if (format != "gr" && format != "hgr") {
+        std::cerr << "Unsupported format: " << format << std::endl;
+        return 1;
+    }
 
-        // Extract total time
-        if (std::regex_search(report, match, timingRegex) && match.size() > 1) {
-            result.second = std::stod(match[1]);
-        }
-    } else if (solver == "scip"){
-        std::regex primalBoundRegex(R"(Primal Bound\s+:\s+([+-]?\d+\.?\d*(e[+-]?\d+)?))");
-        std::regex timingRegex(R"(Solving Time \(sec\)\s+:\s+([\d\.]+))");
-        
-        std::smatch match;
-
-        // Extract primal bound
-        if (std::regex_search(report, match, primalBoundRegex) && match.size() > 1) {
-            result.first = std::stod(match[1]);
-        }
+    std::filesystem::create_directories(outputDir);
+    for (const auto& family : families) {
+        for (int vertices : sizes) {
+            for (int k = 0; k < count; ++k) {
+                auto graph = generateGraph(family, vertices, degree, seed + k);
+                std::string file = outputDir + "/" + family + "_" + std::to_string(vertices) + "_" + std::to_string(seed + k) + "." + format;
 
-        // Extract total time
-        if (std::regex_search(report, match, timingRegex) && match.size() > 1) {
-            result.second = std::stod(match[1]);
-        }
+                std::ofstream out(file);
+                if (!out.is_open()) {
+                    throw std::runtime_error("Could not open the output file: " + file);
+                }
+                if (format == "gr") writeGraph(graph, out);
+                else writeNeighborhoodHypergraph(graph, out);
 
-        return result;
-    } else if (solver == "gurobi") {
-        std::regex primalBoundRegex(R"(Best objective ([+-]?\d+\.?\d*(e[+-]?\d+)?)\,)");
-        std::regex timingRegex(R"(Explored \d+ nodes \(\d+ simplex iterations\) in ([\d\.]+) seconds)");
-        
-        std::smatch match;
-        
-        if (std::regex_search(report, match, primalBoundRegex) && match.size() > 1) {
-            result.first = std::stod(match[1]);
-        }
-        if (std::regex_search(report, match, timingRegex) && match.size() > 1) {
-            result.second = std::stod(match[1]);
+                cout << file << ": " << graph.vertices << " vertices, " << graph.edges.size() << " edges" << endl;
+            }
         }
     }
-
-    return result;
+    return 0;
 }
 
-using std::cout;
-using std::endl;
-
-int main(int argc, char* argv[]) {
-    //std::string name = "ds_exact";
-    //generateCSVForGraphs("../graphs/" + name, "../results/" + name + "/properties2.csv");
-    //generateReductionCSV("../graphs/" + name, "../results/" + name + "/reductions5.csv");
-
+// ./main <graphfile> <solver> [solver arguments] [--components]
+int runSingleMode(int argc, char* argv[]) {
     // Ensure the correct number of arguments are provided
-    if (argc == 1) {
+    if (argc < 3) {
         std::cerr << "Usage: " << argv[0] << " <graphfile> <solver>" << std::endl;
         std::cerr << "Additionally for findminhs: <solutionfile> <settingsfile>" << std::endl;
+        std::cerr << "Additionally for domsat: <cutoff>, for nusc and localsearch: <cutoff> <seed>, for ilp_check: <k>, for portfolio: <time limit> <backend,...>" << std::endl;
+        std::cerr << "Any solver but findminhs and ilp_check also takes --components as its last argument" << std::endl;
+        std::cerr << "A <graphfile> ending in .kernel is a snapshot written by --kernel-dir and is solved as it is" << std::endl;
+        std::cerr << "   or: " << argv[0] << " --batch <directory|listfile> <task[,task...]> [options]" << std::endl;
+        std::cerr << "   or: " << argv[0] << " --generate <family[,family...]> <vertices[,vertices...]> [options]" << std::endl;
         return 1;
     }
 
+    // Trailing flag, so the positional solver arguments keep their places
+    bool components = std::string(argv[argc - 1]) == "--components";
+    if (components) --argc;
+
     // Extract file paths from command line arguments
     std::string graphFile = argv[1];
     std::string solver = argv[2];
-    
-    // Read graph from file
-    //auto graph = readGraphFromFile(graphFile);
-    auto graph = Graph(0);
-    auto hypergraph = readHypergraphFromFile(graphFile);
-    //auto hypergraph = Hypergraph(0,0,0);
+
+    if (!isSolver(solver)) {
+        std::cerr << "Unsupported solver: " << solver << std::endl;
+        return 1;
+    }
+
+    SolverOptions options;
+    if (solver == "findminhs" && argc > 4){
+        options.solutionFile = argv[3];
+        options.settingsFile = argv[4];
+    }
+    if ((solver == "domsat" || solver == "nusc" || solver == "localsearch") && argc > 3) options.timeLimit = std::stoi(argv[3]);
+    if ((solver == "nusc" || solver == "localsearch") && argc > 4) options.seed = argv[4];
+    if (solver == "ilp_check" && argc > 3) options.k = std::stoi(argv[3]);
+    if (solver == "portfolio" && argc > 3) options.timeLimit = std::stoi(argv[3]);
+    if (solver == "portfolio" && argc > 4) options.portfolio = splitList(argv[4]);
+
+    // Read graph from file, a snapshot comes reduced already and brings its forced vertices
+    bool snapshot = graphFile.size() > 7 && graphFile.compare(graphFile.size() - 7, 7, ".kernel") == 0;
+    if (snapshot && (solver == "findminhs" || solver == "ilp_check")) {
+        std::cerr << solver << " reads the plain graph and cannot be run on a kernel snapshot" << std::endl;
+        return 1;
+    }
+    Kernel kernel = snapshot ? readKernel(graphFile) : Kernel{readHypergraphFromFile(graphFile), {}, {}};
+    auto& hypergraph = kernel.hypergraph;
     bool verbose = false;
     bool reductions = false;
-    
-    /*
-    if (reductions){
-        std::vector<int> dominatingSet(0);
-        int isolatedVertexUsage = 0;
-        int singleEdgeVertexUsage = 0;
-        int dominatingVertexUsage = 0;
-        bool changed = true;
-
-        while (changed){
-            changed = false;
-            int currentUsage;
-            
-            currentUsage = graph.reductionIsolatedVertex(dominatingSet, verbose);
-            if (currentUsage != 0) changed = true;
-            isolatedVertexUsage+= currentUsage;
-            
-            currentUsage = graph.reductionSingleEdgeVertex(dominatingSet, verbose);
-            if (currentUsage != 0) changed = true;
-            singleEdgeVertexUsage+= currentUsage;
-
-            currentUsage = graph.reductionDominatingVertex(dominatingSet, verbose);
-            if (currentUsage != 0) changed = true;
-            dominatingVertexUsage+= currentUsage;
-        }
-
-        if (verbose){
-            for (auto node : dominatingSet){
-                cout << node+1 << endl;
-            }
-        }
-    }*/
+    options.verbose = verbose;
+    options.components = components;
 
     if (reductions){
         std::set<int> dominatingSet;
-        int isolatedVertexUsage = 0;
-        int singleEdgeVertexUsage = 0;
-        int dominatingEdgeUsage = 0;
-        int dominatingVertexUsage = 0;
-        int countingRuleUsage = 0;
-
-        isolatedVertexUsage = hypergraph.reductionIsolatedVertex(dominatingSet, verbose);
-        singleEdgeVertexUsage = hypergraph.reductionSingleEdgeVertex(dominatingSet, verbose);
-        countingRuleUsage = hypergraph.reductionCountingRule(dominatingSet, verbose);
-        dominatingEdgeUsage = hypergraph.reductionDominatingEdge(dominatingSet, verbose);
-        dominatingVertexUsage = hypergraph.reductionDominatingVertex(dominatingSet, verbose);
+        auto usage = hypergraph.reduceExhaustively(dominatingSet, verbose);
 
         if (verbose){
-            cout << isolatedVertexUsage << endl;
-            cout << singleEdgeVertexUsage << endl;
-            cout << dominatingEdgeUsage << endl;
-            cout << dominatingVertexUsage << endl;
-            cout << countingRuleUsage << endl;
+            cout << usage.isolatedVertex << endl;
+            cout << usage.singleEdgeVertex << endl;
+            cout << usage.dominatingEdge << endl;
+            cout << usage.dominatingVertex << endl;
+            cout << usage.countingRule << endl;
             cout << dominatingSet.size() << endl;
             cout << endl;
-            
-            //for (auto node : dominatingSet){
-            //    cout << node+1 << endl;
-            //}
         }
     }
 
-    if (solver == "findminhs"){
-        std::string solutionFile = argv[3];
-        std::string settingsFile = argv[4];
-
-        // Convert to hypergraph format for findminhs solver by Felerius (https://github.com/Felerius/findminhs)
-        std::string hypergraphFile = "temp.hgr"; 
-        graph.graphToHypergraph(hypergraphFile);
-
-        // Run findminhs and capture output
-        std::string command = "./findminhs-linux64 solve --solution " + solutionFile + " " + hypergraphFile + " " + settingsFile;
-
-        std::string output = exec(command);
-        if (verbose){
-            std::cout << output;
-            std::cout << std::endl;
-        }
-
-        // Delete temporary hypergraph file
-        std::remove(hypergraphFile.c_str());
-
-        // Output solution
-        if (verbose){
-            std::cout << "Findminhs solver solution:" << std::endl;
-            auto solution = readJsonArray(solutionFile);
-            outputSolution(solution);
-        }
-    }
-
-    if (solver == "highs"){
-        std::string lpFile = "temp.lp";
-        //graph.writeHittingSetILP(lpFile);
-        hypergraph.writeHittingSetLP(lpFile, true);
-
-        std::string command = "./highs " + lpFile;
-        std::string output = exec(command);
-        if (verbose){
-            std::cout << output;
-            std::cout << std::endl;
-        }
-
-        auto result = parseReport(output, solver);
-        cout << result.first << "," << result.second << endl;
-
-        std::remove(lpFile.c_str());
-    }
-
-    if (solver == "scip"){
-        std::string lpFile = "temp.lp";
-        //graph.writeHittingSetILP(lpFile);
-        hypergraph.writeHittingSetLP(lpFile, true);
-        
-        std::string command = "scip -f " + lpFile;
-        std::string output = exec(command);
-        if (verbose){
-            std::cout << output;
-            std::cout << std::endl;
-        }
-        
-        auto result = parseReport(output, solver);
-        cout << result.first << "," << result.second << endl;
-
-        std::remove(lpFile.c_str());
+    auto result = runSolver(solver, graphFile, hypergraph, options);
+    std::vector<int> solution;
+    if (!result.solution.empty()) {
+        solution = liftSolution(kernel, result.solution);
+        result.solutionSize = solution.size();
+    } else if (result.solutionSize >= 0) {
+        result.solutionSize += kernel.forced.size();
     }
 
-    if (solver == "domsat"){
-        std::string cutoff = argv[3];
-
-        // Convert to SAT format for domsat solver
-        std::string SAT_file = "temp.sat"; 
-        //graph.graphToSAT(SAT_file);
-        hypergraph.hypergraphToSAT(SAT_file);
-    
-        // Run domsat and capture output
-        std::string command = "./DomSAT " + SAT_file + " " + cutoff;
-
-        std::string output = exec(command);
-        std::cout << output;
+    if (verbose || solver == "domsat" || solver == "nusc" || solver == "localsearch" || solver == "portfolio"){
+        std::cout << result.output;
         std::cout << std::endl;
-
-        // Delete temporary hypergraph file
-        std::remove(SAT_file.c_str());
     }
 
-    if (solver == "nusc"){
-        std::string cutoff = argv[3];
-        std::string seed = argv[4];
-        
-        // Convert to SAT format for NuSC solver
-        std::string SAT_file = "temp.sat"; 
-        //graph.graphToSAT(SAT_file);
-        hypergraph.hypergraphToSAT(SAT_file);
-    
-        // Run NuSC and capture output
-        std::string command = "./NuSC " + SAT_file + " " + cutoff + " " + seed;
-
-        std::string output = exec(command);
-        std::cout << output;
-        std::cout << std::endl;
-
-        // Delete temporary hypergraph file
-        std::remove(SAT_file.c_str());
+    if (solver == "findminhs" && verbose && !options.solutionFile.empty()){
+        std::cout << "Findminhs solver solution:" << std::endl;
+        auto solution = readJsonArray(options.solutionFile);
+        outputSolution(solution);
     }
 
-    if (solver == "lp"){
-        std::string lpFile = "temp.lp";
-        graph.writeHittingSetLP(lpFile);
-
-        std::string command = "scip -f " + lpFile;
-        std::string output = exec(command);
-        if (verbose){
-            std::cout << output;
-            std::cout << std::endl;
-        }
-        
-        auto result = parseReport(output, "scip");
-        cout << result.first << "," << result.second << endl;
+    if (solver == "highs" || solver == "highs_api" || solver == "scip" || solver == "lp" || solver == "gurobi" || solver == "exact"){
+        cout << result.solutionSize << "," << result.time << endl;
+    }
 
-        std::remove(lpFile.c_str());
+    if (solver == "uwrmaxsat"){
+        cout << result.solutionSize << endl;
+        if (verbose && !solution.empty()) outputSolution(solution);
     }
 
     if (solver == "ilp_check"){
-        int k = std::stoi(argv[3]);
-
-        std::string lpFile = "temp.lp";
-        graph.writeHittingSetILP_check(lpFile, k);
-
-        std::string command = "scip -f " + lpFile;
-        std::string output = exec(command);
-        if (verbose){
-            std::cout << output;
-            std::cout << std::endl;
-        }
-        
-        std::regex infeasibleRegex(R"(Primal Bound\s*:\s*infeasible|problem infeasible)");
-        if (std::regex_search(output, infeasibleRegex)){
-            cout << "infeasible" << endl;
-        } else{
-            cout << "feasible" << endl;
-        }
-
-        std::remove(lpFile.c_str());
+        cout << (result.feasible ? "feasible" : "infeasible") << endl;
     }
 
-    if (solver == "gurobi"){
-        std::string lpFile = "temp.lp";
-        //graph.writeHittingSetILP(lpFile);
-        hypergraph.writeHittingSetLP(lpFile, true);
-        
-        std::string command = "gurobi_cl Threads=1 " + lpFile;
-        std::string output = exec(command);
-        if (verbose){
-            std::cout << output;
-            std::cout << std::endl;
-        }
-        
-        auto result = parseReport(output, solver);
-        cout << result.first << "," << result.second << endl;
-
-        std::remove(lpFile.c_str());
-    }
+    return 0;
+}
 
-    if (solver == "uwrmaxsat"){
-        std::string maxsatFile = "temp.maxsat";
-        hypergraph.writeMaxSAT(maxsatFile);
+int main(int argc, char* argv[]) {
+    //generateCSVForGraphs("../graphs/ds_exact", "../results/ds_exact/properties2.csv");
+    //generateReductionCSV("../graphs/ds_exact", "../results/ds_exact/reductions5.csv");
 
-        std::string command = "./uwrmaxsat -v0 -no-bin -no-sat -no-par -maxpre-time=60 -scip-cpu=800 -scip-delay=400 -m -bm " + maxsatFile;
-        std::string output = exec(command);
-        if (verbose){
-            std::cout << output;
-            std::cout << std::endl;
+    // Report errors through a normal exit, so temporary directories and child processes are cleaned up
+    try {
+        if (argc > 1 && std::string(argv[1]) == "--batch") {
+            return runBatchMode(argc, argv);
         }
-
-        std::smatch match;
-        std::regex lastORegex(R"(o\s+(\d+))");
-        auto lastOIt = std::sregex_iterator(output.begin(), output.end(), lastORegex);
-        auto lastOMatch = std::sregex_iterator();
-
-        int solutionSize = -1;
-
-        if (lastOIt != lastOMatch) {
-            for (auto it = lastOIt; it != lastOMatch; ++it) {
-                match = *it;
-            }
-            solutionSize = std::stoi(match[1]);
+        if (argc > 1 && std::string(argv[1]) == "--generate") {
+            return runGenerateMode(argc, argv);
         }
-
-        cout << solutionSize << endl;
-
-        std::remove(maxsatFile.c_str());
+        return runSingleMode(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
     }
-    
-    return 0;
 }
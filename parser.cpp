@@ -0,0 +1,235 @@
+#include "parser.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile(const std::string& filename){
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Could not open the file!");
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        throw std::runtime_error("Could not stat the file: " + filename);
+    }
+
+    length = static_cast<std::size_t>(info.st_size);
+    if (length > 0) {
+        void* mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            close(fd);
+            throw std::runtime_error("Could not map the file: " + filename);
+        }
+        madvise(mapping, length, MADV_SEQUENTIAL);
+        data = static_cast<const char*>(mapping);
+    }
+    close(fd); // The mapping stays valid after closing the descriptor
+}
+
+MappedFile::~MappedFile(){
+    if (data != nullptr) {
+        munmap(const_cast<char*>(data), length);
+    }
+}
+
+namespace {
+
+inline bool isDigit(char c){
+    return static_cast<unsigned char>(c - '0') < 10;
+}
+
+// Parses the next non-negative integer on the line, returns false once the line is exhausted
+inline bool nextInt(const char*& p, const char* lineEnd, int& value){
+    while (p < lineEnd && !isDigit(*p)) {
+        if (*p != ' ' && *p != '\t' && *p != '\r') {
+            throw std::runtime_error(std::string("Unexpected character '") + *p + "' in input");
+        }
+        ++p;
+    }
+    if (p == lineEnd) return false;
+
+    int result = *p++ - '0';
+    while (p < lineEnd && isDigit(*p)) {
+        int digit = *p++ - '0';
+        if (result > (INT_MAX - digit) / 10) {
+            throw std::runtime_error("Malformed number, larger than INT_MAX!");
+        }
+        result = result * 10 + digit;
+    }
+    value = result;
+    return true;
+}
+
+struct Header {
+    int vertices = 0;
+    int count = 0;          // Edges for .gr, hyperedges for .hgr
+    const char* body = nullptr; // First byte after the problem line
+};
+
+// Finds the "p <descriptor> <vertices> <count>" line, skipping leading comments
+Header readHeader(const MappedFile& file){
+    const char* p = file.begin();
+    const char* end = file.end();
+
+    while (p < end) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        if (lineEnd == nullptr) lineEnd = end;
+
+        if (*p == 'p') {
+            Header header;
+            ++p;
+            while (p < lineEnd && (*p == ' ' || *p == '\t')) ++p;
+            while (p < lineEnd && *p != ' ' && *p != '\t') ++p; // Skip descriptor
+            if (!nextInt(p, lineEnd, header.vertices) || !nextInt(p, lineEnd, header.count)) {
+                throw std::runtime_error("Malformed problem line!");
+            }
+            header.body = lineEnd < end ? lineEnd + 1 : end;
+            return header;
+        }
+        p = lineEnd + 1;
+    }
+    throw std::runtime_error("Missing problem line!");
+}
+
+// Calls handler(begin, end) for every non-empty, non-comment line after the header
+template <typename Handler>
+void forEachDataLine(const char* p, const char* end, Handler&& handler){
+    while (p < end) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        if (lineEnd == nullptr) lineEnd = end;
+
+        if (lineEnd != p && *p != 'c') {
+            handler(p, lineEnd);
+        }
+        p = lineEnd + 1;
+    }
+}
+
+inline void readEdge(const char* p, const char* lineEnd, int vertices, int& u, int& v){
+    if (!nextInt(p, lineEnd, u) || !nextInt(p, lineEnd, v)) {
+        throw std::runtime_error("Malformed edge line!");
+    }
+    if (u < 1 || u > vertices || v < 1 || v > vertices) {
+        throw std::runtime_error("Vertex index out of range!");
+    }
+}
+
+// First pass over a .gr body: degree of every vertex
+std::vector<int> countDegrees(const Header& header, const char* end){
+    std::vector<int> degrees(header.vertices, 0);
+    forEachDataLine(header.body, end, [&](const char* p, const char* lineEnd) {
+        int u, v;
+        readEdge(p, lineEnd, header.vertices, u, v);
+        degrees[u - 1]++;
+        degrees[v - 1]++;
+    });
+    return degrees;
+}
+
+std::string lowercaseExtension(const std::string& filename){
+    std::string extension;
+    auto pos = filename.rfind('.');
+    if (pos != std::string::npos) {
+        extension = filename.substr(pos + 1);
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    }
+    return extension;
+}
+
+} // namespace
+
+// Function to load a graph from a DIMACS-like .gr file format
+Graph readGraphFromFile(const std::string& filename){
+    MappedFile file(filename);
+    Header header = readHeader(file);
+
+    Graph graph(header.vertices);
+    graph.reserveNeighbors(countDegrees(header, file.end()));
+
+    forEachDataLine(header.body, file.end(), [&](const char* p, const char* lineEnd) {
+        int u, v;
+        readEdge(p, lineEnd, header.vertices, u, v);
+        graph.addEdge(u, v);
+    });
+
+    return graph;
+}
+
+// Function to load a hypergraph from a DIMACS-like .gr file (closed neighborhoods) or a .hgr file
+Hypergraph readHypergraphFromFile(const std::string& filename){
+    std::string extension = lowercaseExtension(filename);
+    if (extension != "gr" && extension != "hgr") {
+        throw std::runtime_error("Unsupported file extension: " + extension);
+    }
+
+    MappedFile file(filename);
+    Header header = readHeader(file);
+
+    if (extension == "gr"){
+        int vertex_count = header.vertices;
+
+        // Closed neighborhood of each vertex: its degree plus the vertex itself
+        std::vector<int> sizes = countDegrees(header, file.end());
+        for (auto& size : sizes) size++;
+
+        Hypergraph hypergraph(vertex_count, vertex_count, vertex_count);
+        hypergraph.reserveHyperedges(sizes);
+        hypergraph.initEdge(vertex_count);
+        forEachDataLine(header.body, file.end(), [&](const char* p, const char* lineEnd) {
+            int u, v;
+            readEdge(p, lineEnd, vertex_count, u, v);
+            hypergraph.addEdge(u, v);
+        });
+        hypergraph.setVertexToHyperedges();
+
+        return hypergraph;
+    }
+
+    int vertex_count = header.vertices;
+    int set_count = header.count;
+
+    // First pass: size of every hyperedge
+    std::vector<int> sizes;
+    sizes.reserve(set_count);
+    forEachDataLine(header.body, file.end(), [&](const char* p, const char* lineEnd) {
+        int size = 0;
+        int vertex;
+        while (nextInt(p, lineEnd, vertex)) {
+            if (vertex < 1 || vertex > vertex_count) {
+                throw std::runtime_error("Vertex index out of range!");
+            }
+            size++;
+        }
+        if (size > 0) sizes.push_back(size);
+    });
+    if (static_cast<int>(sizes.size()) > set_count) {
+        throw std::runtime_error("More hyperedges than declared in the problem line!");
+    }
+    sizes.resize(set_count, 0);
+
+    // Second pass: write every vertex straight into its hyperedge
+    Hypergraph hypergraph(set_count, set_count, vertex_count);
+    hypergraph.reserveHyperedges(sizes);
+    int count = 0;
+    forEachDataLine(header.body, file.end(), [&](const char* p, const char* lineEnd) {
+        int vertex;
+        bool empty = true;
+        while (nextInt(p, lineEnd, vertex)) {
+            hypergraph.addVertexToHyperedge(count, vertex - 1);
+            empty = false;
+        }
+        if (!empty) count++;
+    });
+    hypergraph.setVertexToHyperedges();
+
+    return hypergraph;
+}
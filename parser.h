@@ -0,0 +1,32 @@
+#ifndef PARSER_H
+#define PARSER_H
+
+#include <string>
+#include <cstddef>
+
+#include "graph.h"
+#include "hypergraph2.h"
+
+// Read-only memory mapping of a whole file, unmapped on destruction
+class MappedFile {
+private:
+    const char* data = nullptr;
+    std::size_t length = 0;
+
+public:
+    explicit MappedFile(const std::string& filename);
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* begin() const {return data;};
+    const char* end() const {return data + length;};
+    std::size_t size() const {return length;};
+};
+
+// Loaders for the PACE .gr format and the findminhs-like .hgr format.
+// Both scan the mapped file twice: once to count degrees, once to write into the reserved storage.
+Graph readGraphFromFile(const std::string& filename);
+Hypergraph readHypergraphFromFile(const std::string& filename);
+
+#endif // PARSER_H
@@ -0,0 +1,197 @@
+#include "portfolio.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+
+#include "exact.h"
+#include "localsearch.h"
+
+namespace {
+
+// Heuristics that keep improving until they are stopped, they never finish on their own
+bool isAnytimeBackend(const std::string& backend){
+    return backend == "greedy" || backend == "localsearch";
+}
+
+// Best bounds of the race so far. Backends offer what they find, the waiting thread is woken
+// whenever something changes.
+class SharedBounds {
+private:
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::chrono::steady_clock::time_point start;
+    int running;
+    int runningFinite;          // Backends that end on their own, everything but the anytime heuristics
+    PortfolioResult result;
+
+    double elapsed() const{
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void checkMet(){
+        if (result.solutionSize >= 0 && result.lowerBound >= result.solutionSize) {
+            result.lowerBound = result.solutionSize;
+            result.optimal = true;
+            stop = true;
+        }
+        changed.notify_all();
+    }
+
+public:
+    std::atomic<int> upper{INT_MAX};
+    std::atomic<bool> stop{false};
+
+    explicit SharedBounds(const std::vector<std::string>& backends)
+        : start(std::chrono::steady_clock::now()), running(backends.size()),
+          runningFinite(std::count_if(backends.begin(), backends.end(), [](const std::string& b) {return !isAnytimeBackend(b);})) {}
+
+    void offerSolution(const std::string& backend, int size, const std::vector<int>* solution){
+        std::lock_guard<std::mutex> lock(mutex);
+        if (result.solutionSize >= 0 && size >= result.solutionSize) return;
+
+        result.solutionSize = size;
+        result.winner = backend;
+        result.solution = solution ? *solution : std::vector<int>();
+        upper = size;
+
+        std::ostringstream line;
+        line << "o " << size << " " << elapsed() << " " << backend << "\n";
+        result.log += line.str();
+        checkMet();
+    }
+
+    void offerLowerBound(const std::string& backend, int bound){
+        std::lock_guard<std::mutex> lock(mutex);
+        if (bound <= result.lowerBound) return;
+
+        result.lowerBound = bound;
+
+        std::ostringstream line;
+        line << "l " << bound << " " << elapsed() << " " << backend << "\n";
+        result.log += line.str();
+        checkMet();
+    }
+
+    void note(const std::string& backend, const std::string& message){
+        std::lock_guard<std::mutex> lock(mutex);
+        result.log += "c " + backend + ": " + message + "\n";
+    }
+
+    void finished(const std::string& backend){
+        std::lock_guard<std::mutex> lock(mutex);
+        running--;
+        if (!isAnytimeBackend(backend)) runningFinite--;
+        changed.notify_all();
+    }
+
+    // Until the bounds meet, every backend is done, or the time limit passes. Without a time
+    // limit nothing would end the anytime heuristics, so only the other backends are waited for
+    void wait(double timeLimit){
+        std::unique_lock<std::mutex> lock(mutex);
+        auto done = [this, timeLimit]() { return stop || running == 0 || (timeLimit <= 0 && runningFinite == 0); };
+        if (timeLimit > 0) {
+            changed.wait_until(lock, start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(timeLimit)), done);
+        } else {
+            changed.wait(lock, done);
+        }
+        result.time = elapsed(); // Stopping the backends afterwards does not count
+    }
+
+    PortfolioResult take(){
+        std::lock_guard<std::mutex> lock(mutex);
+        return result;
+    }
+};
+
+// Solvers that prove their answer optimal when they finish on their own
+bool isExactBackend(const std::string& backend){
+    return backend == "highs" || backend == "highs_api" || backend == "scip" || backend == "gurobi" || backend == "uwrmaxsat";
+}
+
+void runBackend(const std::string& backend, const Hypergraph& kernel, const SolverOptions& options, SharedBounds& shared){
+    if (backend == "greedy") {
+        auto solution = kernel.greedyHittingSet();
+        shared.offerSolution(backend, solution.size(), &solution);
+    } else if (backend == "localsearch") {
+        LocalSearchOptions searchOptions;
+        searchOptions.timeLimit = options.timeLimit > 0 ? options.timeLimit : std::numeric_limits<double>::infinity();
+        searchOptions.seed = std::stoul(options.seed);
+        searchOptions.stop = &shared.stop;
+
+        LocalSearch search(kernel, searchOptions);
+        search.setCallback([&](const std::vector<int>& solution, double) {
+            shared.offerSolution(backend, solution.size(), &solution);
+        });
+        search.run();
+    } else if (backend == "exact") {
+        Hypergraph copy = kernel;
+        ExactOptions exactOptions;
+        exactOptions.timeLimit = options.timeLimit;
+        exactOptions.knownLowerBound = options.lowerBound;
+        exactOptions.stop = &shared.stop;
+        exactOptions.sharedUpperBound = &shared.upper;
+        exactOptions.onImprovement = [&](const std::vector<int>& solution) {
+            shared.offerSolution(backend, solution.size(), &solution);
+        };
+        exactOptions.onLowerBound = [&](int bound) { shared.offerLowerBound(backend, bound); };
+        BranchAndReduce(copy, exactOptions).solve();
+    } else if (isSolver(backend) && backend != "findminhs" && backend != "ilp_check" && backend != "portfolio") {
+        SolverOptions backendOptions = options;
+        backendOptions.stop = &shared.stop;
+        auto result = runSolver(backend, "", kernel, backendOptions);
+        if (result.solutionSize < 0) {
+            shared.note(backend, "no solution reported");
+            return;
+        }
+
+        if (backend == "lp") {
+            shared.offerLowerBound(backend, static_cast<int>(std::ceil(result.solutionSize - 1e-6))); // Relaxation
+            return;
+        }
+        shared.offerSolution(backend, static_cast<int>(std::lround(result.solutionSize)), result.solution.empty() ? nullptr : &result.solution);
+        if (isExactBackend(backend) && !result.timedOut) {
+            shared.offerLowerBound(backend, static_cast<int>(std::lround(result.solutionSize)));
+        }
+    } else {
+        throw std::runtime_error("Unsupported portfolio backend: " + backend);
+    }
+}
+
+} // namespace
+
+const std::vector<std::string>& defaultPortfolio(){
+    static const std::vector<std::string> backends = {"greedy", "localsearch", "exact", "highs", "scip", "uwrmaxsat"};
+    return backends;
+}
+
+PortfolioResult runPortfolio(const Hypergraph& kernel, const std::vector<std::string>& backends, const SolverOptions& options){
+    SharedBounds shared(backends);
+    if (options.lowerBound > 0) shared.offerLowerBound("given", options.lowerBound);
+
+    std::vector<std::thread> threads;
+    for (const auto& backend : backends) {
+        threads.emplace_back([&, backend]() {
+            try {
+                runBackend(backend, kernel, options, shared);
+            } catch (const std::exception& e) {
+                shared.note(backend, e.what());
+            }
+            shared.finished(backend);
+        });
+    }
+
+    shared.wait(options.timeLimit);
+    shared.stop = true;
+    for (auto& thread : threads) thread.join();
+
+    return shared.take();
+}
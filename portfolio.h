@@ -0,0 +1,30 @@
+#ifndef PORTFOLIO_H
+#define PORTFOLIO_H
+
+#include <string>
+#include <vector>
+
+#include "hypergraph2.h"
+#include "solvers.h"
+
+struct PortfolioResult {
+    int solutionSize = -1;      // Best size any backend reached, -1 if none did
+    int lowerBound = 0;         // Best lower bound any backend proved
+    bool optimal = false;       // The bounds met
+    std::string winner;         // Backend that found the best solution
+    std::vector<int> solution;  // Only filled if the winner runs in-process
+    double time = 0;            // Until the bounds met, every backend gave up or the time limit passed
+    std::string log;            // "o <size> <time> <backend>" and "l <bound> <time> <backend>" per improvement
+};
+
+// greedy, localsearch, exact, highs, scip and uwrmaxsat
+const std::vector<std::string>& defaultPortfolio();
+
+// Races the backends on the active part of the kernel, one thread each. Solutions and lower
+// bounds are shared as they come in, the exact solver prunes with the best solution of all of
+// them, and everything is stopped as soon as the best solution meets the best lower bound.
+// Besides "greedy", every solver of runSolver() that works on the hypergraph alone can take part.
+// Without a time limit the race ends once only greedy and localsearch are left running.
+PortfolioResult runPortfolio(const Hypergraph& kernel, const std::vector<std::string>& backends, const SolverOptions& options);
+
+#endif // PORTFOLIO_H
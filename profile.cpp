@@ -0,0 +1,134 @@
+#include "profile.h"
+
+#include <map>
+#include <algorithm>
+
+namespace {
+
+thread_local Profile* currentProfile = nullptr;
+
+const char* ruleNames[Profile::NumRules] = {"Isolated", "Single Edge", "Dominating Edge", "Dominating Vertex", "Counting Rule"};
+const char* counterNames[Profile::NumCounters] = {"Candidate Pairs", "Subset Tests", "Bytes Written"};
+
+// Phase names in order of first appearance over all profiles
+std::vector<std::string> phaseNames(const std::vector<const Profile*>& profiles){
+    std::vector<std::string> names;
+    for (const Profile* profile : profiles) {
+        for (const auto& span : profile->spans()) {
+            if (std::find(names.begin(), names.end(), span.name) == names.end()) names.push_back(span.name);
+        }
+    }
+    return names;
+}
+
+// Instance names are file names, only quotes, backslashes and control characters need care
+std::string jsonString(const std::string& text){
+    std::string quoted = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') quoted += '\\';
+        if (static_cast<unsigned char>(c) < 0x20) continue;
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+} // namespace
+
+std::vector<Profile::Span> Profile::spans() const{
+    std::lock_guard<std::mutex> lock(mutex);
+    return spanList;
+}
+
+void Profile::addSpan(const std::string& name, double start, double end){
+    std::lock_guard<std::mutex> lock(mutex);
+    spanList.push_back({name, start, end, std::this_thread::get_id()});
+}
+
+Profile* Profile::current(){
+    return currentProfile;
+}
+
+ProfileScope::ProfileScope(Profile* profile) : previous(currentProfile) {
+    currentProfile = profile;
+}
+
+ProfileScope::~ProfileScope(){
+    currentProfile = previous;
+}
+
+void writeProfileCSV(std::ostream& out, const std::vector<const Profile*>& profiles){
+    auto phases = phaseNames(profiles);
+
+    out << "Name";
+    for (const auto& phase : phases) out << "," << phase << " (s)";
+    for (const char* rule : ruleNames) out << "," << rule << " (s)," << rule << " Attempts";
+    for (const char* counter : counterNames) out << "," << counter;
+    out << "\n";
+
+    for (const Profile* profile : profiles) {
+        std::map<std::string, double> seconds;
+        for (const auto& span : profile->spans()) seconds[span.name] += span.end - span.start;
+
+        out << profile->name();
+        for (const auto& phase : phases) {
+            out << ",";
+            if (seconds.count(phase)) out << seconds[phase];
+        }
+        for (int r = 0; r < Profile::NumRules; ++r) out << "," << profile->ruleSeconds[r] << "," << profile->ruleAttempts[r];
+        for (int c = 0; c < Profile::NumCounters; ++c) out << "," << profile->counters[c];
+        out << "\n";
+    }
+}
+
+void writeProfileTrace(std::ostream& out, const std::vector<const Profile*>& profiles){
+    // Timestamps are microseconds since the earliest span, tracks are numbered by first appearance
+    double epoch = -1;
+    std::vector<std::thread::id> threads;
+    for (const Profile* profile : profiles) {
+        for (const auto& span : profile->spans()) {
+            if (epoch < 0 || span.start < epoch) epoch = span.start;
+            if (std::find(threads.begin(), threads.end(), span.thread) == threads.end()) threads.push_back(span.thread);
+        }
+    }
+    auto track = [&](std::thread::id thread) {
+        return std::find(threads.begin(), threads.end(), thread) - threads.begin() + 1;
+    };
+    auto micros = [&](double seconds) {
+        return static_cast<long long>((seconds - epoch) * 1e6);
+    };
+
+    out << "{\"traceEvents\":[";
+    bool first = true;
+    auto event = [&](const std::string& name, const std::string& instance, double start, double end, std::thread::id thread, const std::string& args) {
+        if (!first) out << ",";
+        first = false;
+        out << "\n{\"name\":" << jsonString(name) << ",\"cat\":" << jsonString(instance)
+            << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << track(thread)
+            << ",\"ts\":" << micros(start) << ",\"dur\":" << micros(end) - micros(start)
+            << ",\"args\":{" << args << "}}";
+    };
+
+    for (const Profile* profile : profiles) {
+        auto spans = profile->spans();
+        if (spans.empty()) continue;
+
+        // The instance span covers its phases on the thread that recorded the first one
+        double start = spans.front().start, end = spans.front().end;
+        for (const auto& span : spans) {
+            start = std::min(start, span.start);
+            end = std::max(end, span.end);
+        }
+        std::string args;
+        for (int r = 0; r < Profile::NumRules; ++r) {
+            args += jsonString(std::string(ruleNames[r]) + " (s)") + ":" + std::to_string(profile->ruleSeconds[r]) + ",";
+            args += jsonString(std::string(ruleNames[r]) + " Attempts") + ":" + std::to_string(profile->ruleAttempts[r]) + ",";
+        }
+        for (int c = 0; c < Profile::NumCounters; ++c) {
+            args += jsonString(counterNames[c]) + ":" + std::to_string(profile->counters[c]) + (c + 1 < Profile::NumCounters ? "," : "");
+        }
+        event(profile->name(), profile->name(), start, end, spans.front().thread, args);
+
+        for (const auto& span : spans) event(span.name, profile->name(), span.start, span.end, span.thread, "");
+    }
+    out << "\n]}\n";
+}
@@ -0,0 +1,110 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <string>
+#include <vector>
+#include <array>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <ostream>
+
+// Where the time of one instance goes. Phases (reading, reducing, exporting, solving) are
+// recorded as spans; the reduction rules are timed per attempt and count the candidates they
+// look at. Nothing is recorded unless a ProfileScope made a profile current on the thread.
+class Profile {
+public:
+    enum Rule {IsolatedVertex, SingleEdgeVertex, DominatingEdge, DominatingVertex, CountingRule, NumRules};
+    enum Counter {CandidatePairs, SubsetTests, BytesWritten, NumCounters};
+
+    struct Span {
+        std::string name;
+        double start;           // Seconds on the steady clock
+        double end;
+        std::thread::id thread;
+    };
+
+    // Only touched by the threads the profile is current on, which never run at the same time
+    std::array<double, NumRules> ruleSeconds{};
+    std::array<long long, NumRules> ruleAttempts{};
+    std::array<long long, NumCounters> counters{};
+
+    explicit Profile(std::string instance) : instance(std::move(instance)) {}
+
+    const std::string& name() const {return instance;};
+    std::vector<Span> spans() const;
+    void addSpan(const std::string& name, double start, double end);
+
+    // Profile of the calling thread, nullptr if none
+    static Profile* current();
+    static double now(){
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+private:
+    std::string instance;
+    mutable std::mutex mutex;   // Spans may come from a model writer thread
+    std::vector<Span> spanList;
+};
+
+// Makes profile current on this thread for its lifetime, nullptr turns profiling off
+class ProfileScope {
+private:
+    Profile* previous;
+
+public:
+    explicit ProfileScope(Profile* profile);
+    ~ProfileScope();
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+};
+
+// Records the enclosing block as a span of the current profile
+class ProfileSpan {
+private:
+    Profile* profile;
+    std::string name;
+    double start = 0;
+
+public:
+    explicit ProfileSpan(std::string name) : profile(Profile::current()), name(std::move(name)) {
+        if (profile) start = Profile::now();
+    }
+    ~ProfileSpan() {
+        if (profile) profile->addSpan(name, start, Profile::now());
+    }
+
+    ProfileSpan(const ProfileSpan&) = delete;
+    ProfileSpan& operator=(const ProfileSpan&) = delete;
+};
+
+// Times one attempt of a reduction rule, costs a single test when profile is nullptr
+class RuleTimer {
+private:
+    Profile* profile;
+    Profile::Rule rule;
+    double start = 0;
+
+public:
+    RuleTimer(Profile* profile, Profile::Rule rule) : profile(profile), rule(rule) {
+        if (profile) start = Profile::now();
+    }
+    ~RuleTimer() {
+        if (!profile) return;
+        profile->ruleSeconds[rule] += Profile::now() - start;
+        profile->ruleAttempts[rule]++;
+    }
+
+    RuleTimer(const RuleTimer&) = delete;
+    RuleTimer& operator=(const RuleTimer&) = delete;
+};
+
+// One CSV row per profile: seconds per phase, then per rule seconds and attempts, then counters
+void writeProfileCSV(std::ostream& out, const std::vector<const Profile*>& profiles);
+
+// Trace Event Format as read by chrome://tracing and Perfetto: one track per worker thread,
+// a span per instance and phase, the rule totals and counters as arguments of the instance span
+void writeProfileTrace(std::ostream& out, const std::vector<const Profile*>& profiles);
+
+#endif // PROFILE_H
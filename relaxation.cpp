@@ -0,0 +1,193 @@
+#include "relaxation.h"
+
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include <limits>
+
+#include "csr.h"
+#include "localsearch.h"
+
+namespace {
+
+const double epsilon = 1e-6;
+
+// Smallest integer not below value, tolerant to rounding noise of the subgradient steps
+int ceilBound(double value){
+    return static_cast<int>(std::ceil(value - epsilon));
+}
+
+// Active part of the hypergraph, renumbered: elements are the active hyperedges,
+// sets the usable vertices covering at least one of them
+struct Residual {
+    CSR setsOf;                 // Sets hitting each element
+    CSR elementsOf;             // Elements hit by each set
+    std::vector<int> original;  // Original vertex of each set
+};
+
+Residual buildResidual(const Hypergraph& hypergraph){
+    int n = hypergraph.numVertices();
+    int m = hypergraph.numHyperedges();
+
+    Residual residual;
+    std::vector<int> localId(n, -1);
+    std::vector<int> sizes;
+    for (int e = 0; e < m; ++e) {
+        if (!hypergraph.isActive(e)) continue;
+        int size = 0;
+        for (int v : hypergraph.verticesOf(e)) {
+            if (!hypergraph.isUsable(v)) continue;
+            if (localId[v] == -1) {
+                localId[v] = residual.original.size();
+                residual.original.push_back(v);
+            }
+            size++;
+        }
+        sizes.push_back(size);
+    }
+
+    residual.setsOf.setRowSizes(sizes);
+    int element = 0;
+    for (int e = 0; e < m; ++e) {
+        if (!hypergraph.isActive(e)) continue;
+        for (int v : hypergraph.verticesOf(e)) {
+            if (hypergraph.isUsable(v)) residual.setsOf.append(element, localId[v]);
+        }
+        element++;
+    }
+    residual.elementsOf = residual.setsOf.transpose(residual.original.size());
+    return residual;
+}
+
+struct Multipliers {
+    double value = 0;               // Lagrangian bound of the best multipliers
+    std::vector<double> reducedCost; // Per set, at the best multipliers
+};
+
+// Subgradient optimization of the Lagrangian dual in the style of Beasley's set covering
+// heuristics: the step shrinks whenever the bound stalls, upperBound only steers the step size
+Multipliers solveDual(const Residual& residual, int upperBound, int iterations){
+    int elements = residual.setsOf.size();
+    int sets = residual.original.size();
+
+    // Start dual feasible: every set spreads a total weight of at most one over its elements
+    std::vector<double> u(elements);
+    for (int e = 0; e < elements; ++e) {
+        double smallest = 1.0;
+        for (int s : residual.setsOf[e]) smallest = std::min(smallest, 1.0 / residual.elementsOf.degree(s));
+        u[e] = smallest;
+    }
+
+    Multipliers best;
+    best.value = -1;
+    std::vector<double> cost(sets);
+    std::vector<char> taken(sets);
+    std::vector<double> subgradient(elements);
+    double factor = 2.0;
+    int stalled = 0;
+
+    for (int iteration = 0; iteration < iterations && factor > 1e-3; ++iteration) {
+        double bound = 0;
+        for (int e = 0; e < elements; ++e) bound += u[e];
+        for (int s = 0; s < sets; ++s) {
+            double load = 0;
+            for (int e : residual.elementsOf[s]) load += u[e];
+            cost[s] = 1.0 - load;
+            taken[s] = cost[s] < 0;
+            if (taken[s]) bound += cost[s];
+        }
+
+        if (bound > best.value + epsilon) {
+            best.value = bound;
+            best.reducedCost = cost;
+            stalled = 0;
+        } else if (++stalled >= 20) {
+            factor /= 2;
+            stalled = 0;
+        }
+        if (ceilBound(best.value) >= upperBound) break; // The greedy solution is optimal
+
+        double norm = 0;
+        for (int e = 0; e < elements; ++e) {
+            int hits = 0;
+            for (int s : residual.setsOf[e]) hits += taken[s];
+            subgradient[e] = 1 - hits;
+            if (u[e] <= 0 && subgradient[e] < 0) subgradient[e] = 0; // Multipliers stay non-negative
+            norm += subgradient[e] * subgradient[e];
+        }
+        if (norm == 0) break; // The Lagrangian solution covers everything exactly once, the bound is tight
+
+        double step = factor * (1.05 * upperBound - bound) / norm;
+        for (int e = 0; e < elements; ++e) {
+            u[e] = std::max(0.0, u[e] + step * subgradient[e]);
+        }
+    }
+    return best;
+}
+
+void addCounts(ReductionCounts& total, const ReductionCounts& counts){
+    total.isolatedVertex += counts.isolatedVertex;
+    total.singleEdgeVertex += counts.singleEdgeVertex;
+    total.dominatingEdge += counts.dominatingEdge;
+    total.dominatingVertex += counts.dominatingVertex;
+    total.countingRule += counts.countingRule;
+}
+
+} // namespace
+
+RelaxationResult reduceByRelaxation(Hypergraph& hypergraph, std::set<int>& dominatingSet, const RelaxationOptions& options){
+    RelaxationResult result;
+
+    for (int round = 0; round < options.rounds; ++round) {
+        Residual residual = buildResidual(hypergraph);
+        if (residual.setsOf.size() == 0) {
+            result.lowerBound = 0;
+            result.relaxationValue = 0;
+            result.upperBound = 0;
+            break;
+        }
+
+        int upperBound = hypergraph.greedyHittingSet().size();
+        if (options.searchSteps > 0) {
+            LocalSearchOptions searchOptions;
+            searchOptions.maxSteps = options.searchSteps;
+            searchOptions.timeLimit = std::numeric_limits<double>::infinity();
+            searchOptions.seed = options.seed;
+            upperBound = std::min<int>(upperBound, LocalSearch(hypergraph, searchOptions).run().solution.size());
+        }
+        Multipliers dual = solveDual(residual, upperBound, options.iterations);
+        result.upperBound = upperBound;
+        result.relaxationValue = dual.value;
+        result.lowerBound = ceilBound(dual.value);
+
+        if (options.verbose) {
+            std::cout << "Relaxation round " << round + 1 << ": bounds " << dual.value << " - " << upperBound << std::endl;
+        }
+
+        // The last round only measures, so the bound belongs to the kernel that is handed on
+        if (round + 1 == options.rounds) break;
+
+        std::vector<int> choose, exclude;
+        for (size_t s = 0; s < residual.original.size(); ++s) {
+            double cost = dual.reducedCost[s];
+            if (cost > 0 && ceilBound(dual.value + cost) > upperBound) exclude.push_back(residual.original[s]);
+            if (cost < 0 && ceilBound(dual.value - cost) > upperBound) choose.push_back(residual.original[s]);
+        }
+        if (choose.empty() && exclude.empty()) break;
+
+        for (int v : exclude) hypergraph.excludeVertex(v);
+        for (int v : choose) hypergraph.selectVertex(v, dominatingSet);
+        addCounts(result.propagated, hypergraph.propagate(dominatingSet, options.verbose));
+        if (hypergraph.hasConflict()) {
+            throw std::runtime_error("LP fixing left a hyperedge without usable vertices");
+        }
+
+        result.fixedToZero += exclude.size();
+        result.fixedToOne += choose.size();
+        if (options.verbose) {
+            std::cout << "Relaxation fixed " << choose.size() << " to one and " << exclude.size() << " to zero" << std::endl;
+        }
+    }
+    return result;
+}
@@ -0,0 +1,36 @@
+#ifndef RELAXATION_H
+#define RELAXATION_H
+
+#include <vector>
+#include <set>
+
+#include "hypergraph2.h"
+
+struct RelaxationOptions {
+    int iterations = 500;       // Subgradient steps per round
+    int rounds = 5;             // Fix, propagate and solve again at most this often
+    long long searchSteps = 20000; // Local search steps improving the upper bound per round, 0 keeps the greedy one
+    unsigned seed = 1;
+    bool verbose = false;
+};
+
+struct RelaxationResult {
+    int lowerBound = 0;         // Proven bound on the size of any hitting set of the remaining kernel
+    double relaxationValue = 0; // Best dual value found, lowerBound is its ceiling
+    int upperBound = 0;         // Best solution of the kernel the fixing was measured against
+    int fixedToOne = 0;
+    int fixedToZero = 0;
+    ReductionCounts propagated; // Reductions the fixings triggered
+};
+
+// LP relaxation stage for the kernel: min sum x_v subject to every active hyperedge being hit,
+// 0 <= x_v <= 1. Its dual is approximated by subgradient optimization of the Lagrangian with
+// one multiplier per active hyperedge, whose value is a lower bound at every step.
+// With bound L and reduced cost c_v = 1 - (sum of the multipliers of v's hyperedges), every
+// solution containing v has size at least L + c_v, and every solution without it at least L - c_v.
+// If that exceeds the size of a known solution (greedy, improved by a short local search),
+// v is excluded or chosen. The fixings are propagated with
+// the reduction rules and the relaxation is solved again on what is left.
+RelaxationResult reduceByRelaxation(Hypergraph& hypergraph, std::set<int>& dominatingSet, const RelaxationOptions& options = RelaxationOptions());
+
+#endif // RELAXATION_H
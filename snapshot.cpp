@@ -0,0 +1,281 @@
+#include "snapshot.h"
+
+#include <cstdint>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <atomic>
+#include <fstream>
+#include <filesystem>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "parser.h"
+
+namespace {
+
+static_assert(sizeof(std::size_t) == sizeof(std::uint64_t), "Snapshots store CSR offsets as they are in memory");
+
+const char snapshotMagic[8] = {'D', 'S', 'K', 'E', 'R', 'N', 'E', 'L'};
+const std::uint32_t snapshotVersion = 2;
+
+struct SnapshotHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t reserved;
+    std::uint64_t hyperedges;
+    std::uint64_t vertices;
+    std::uint64_t entries;      // Nonzeros, the same in both directions
+    std::uint64_t forced;
+    std::uint64_t sourceSize;
+    std::int64_t sourceTime;    // Nanoseconds, copies made within a second differ
+    std::uint64_t sourcePath;   // Hash of the canonical path, equal copies elsewhere differ
+};
+
+std::uint64_t padded(std::uint64_t bytes){
+    return (bytes + 7) & ~std::uint64_t(7);
+}
+
+std::uint64_t bitmapWords(std::uint64_t bits){
+    return (bits + 63) / 64;
+}
+
+// Bytes of the whole file, the readers check it before touching any array
+std::uint64_t snapshotSize(const SnapshotHeader& header){
+    std::uint64_t size = sizeof(SnapshotHeader);
+    size += (header.hyperedges + 1) * sizeof(std::uint64_t) + padded(header.entries * sizeof(int));
+    size += (header.vertices + 1) * sizeof(std::uint64_t) + padded(header.entries * sizeof(int));
+    size += (bitmapWords(header.hyperedges) + bitmapWords(header.vertices)) * sizeof(std::uint64_t);
+    size += padded(header.forced * sizeof(int)) + padded(header.vertices * sizeof(int));
+    return size;
+}
+
+// FNV-1a, stable across builds so snapshots keep their names
+std::uint64_t pathHash(const std::string& path){
+    std::uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : path) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+std::uint64_t canonicalPathHash(const std::string& source){
+    std::error_code error;
+    auto canonical = std::filesystem::canonical(source, error);
+    if (error) {
+        throw std::runtime_error("Could not resolve the path: " + source);
+    }
+    return pathHash(canonical.string());
+}
+
+void sourceStamp(const std::string& source, SnapshotHeader& header){
+    struct stat info;
+    if (stat(source.c_str(), &info) != 0) {
+        throw std::runtime_error("Could not stat the file: " + source);
+    }
+    header.sourceSize = info.st_size;
+    header.sourceTime = static_cast<std::int64_t>(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+    header.sourcePath = canonicalPathHash(source);
+}
+
+void writeBytes(std::ofstream& file, const void* data, std::uint64_t bytes){
+    static const char zeros[8] = {};
+    file.write(static_cast<const char*>(data), bytes);
+    file.write(zeros, padded(bytes) - bytes);
+}
+
+void writeBitmap(std::ofstream& file, const std::vector<bool>& flags){
+    std::vector<std::uint64_t> words(bitmapWords(flags.size()), 0);
+    for (size_t i = 0; i < flags.size(); ++i) {
+        if (flags[i]) words[i / 64] |= std::uint64_t(1) << (i % 64);
+    }
+    writeBytes(file, words.data(), words.size() * sizeof(std::uint64_t));
+}
+
+// Sequential reader over the mapped arrays, in the order writeKernel put them
+class SnapshotCursor {
+private:
+    const char* p;
+
+public:
+    explicit SnapshotCursor(const char* p) : p(p) {}
+
+    template <typename T>
+    const T* take(std::uint64_t count){
+        const T* array = reinterpret_cast<const T*>(p);
+        p += padded(count * sizeof(T));
+        return array;
+    }
+};
+
+// Every entry of a row is an index into the other side, below columns
+CSR readRows(SnapshotCursor& cursor, std::uint64_t rows, std::uint64_t entries, std::uint64_t columns){
+    const std::size_t* offsets = cursor.take<std::size_t>(rows + 1);
+    const int* indices = cursor.take<int>(entries);
+    if (offsets[0] != 0 || offsets[rows] != entries) {
+        throw std::runtime_error("Corrupt kernel snapshot");
+    }
+    for (std::uint64_t r = 0; r < rows; ++r) {
+        if (offsets[r] > offsets[r + 1]) throw std::runtime_error("Corrupt kernel snapshot");
+    }
+    for (std::uint64_t i = 0; i < entries; ++i) {
+        if (indices[i] < 0 || static_cast<std::uint64_t>(indices[i]) >= columns) throw std::runtime_error("Corrupt kernel snapshot");
+    }
+
+    CSR result;
+    result.assignRaw(offsets, rows, indices);
+    return result;
+}
+
+std::vector<bool> readBitmap(SnapshotCursor& cursor, std::uint64_t bits){
+    const std::uint64_t* words = cursor.take<std::uint64_t>(bitmapWords(bits));
+    std::vector<bool> flags(bits);
+    for (std::uint64_t i = 0; i < bits; ++i) {
+        flags[i] = (words[i / 64] >> (i % 64)) & 1;
+    }
+    return flags;
+}
+
+SnapshotHeader readHeader(const MappedFile& file){
+    SnapshotHeader header;
+    if (file.size() < sizeof(SnapshotHeader)) {
+        throw std::runtime_error("Not a kernel snapshot");
+    }
+    std::memcpy(&header, file.begin(), sizeof(SnapshotHeader));
+    if (std::memcmp(header.magic, snapshotMagic, sizeof(snapshotMagic)) != 0) {
+        throw std::runtime_error("Not a kernel snapshot");
+    }
+    if (header.version != snapshotVersion) {
+        throw std::runtime_error("Unsupported kernel snapshot version " + std::to_string(header.version));
+    }
+    if (file.size() != snapshotSize(header)) {
+        throw std::runtime_error("Truncated kernel snapshot");
+    }
+    return header;
+}
+
+std::string baseName(const std::string& path){
+    auto slash = path.find_last_of('/');
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+} // namespace
+
+void writeKernel(const std::string& filename, const Hypergraph& hypergraph, const std::set<int>& forced, const std::vector<int>& originalIds, const std::string& source){
+    const CSR& hyperedges = hypergraph.hyperedgeRows();
+    const CSR& incidences = hypergraph.incidenceRows();
+    if (originalIds.size() != incidences.size()) {
+        throw std::runtime_error("Id mapping does not match the hypergraph");
+    }
+
+    SnapshotHeader header = {};
+    std::memcpy(header.magic, snapshotMagic, sizeof(snapshotMagic));
+    header.version = snapshotVersion;
+    header.hyperedges = hyperedges.size();
+    header.vertices = incidences.size();
+    header.entries = hyperedges.entries();
+    header.forced = forced.size();
+    sourceStamp(source, header);
+
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open file: " + filename);
+    }
+
+    std::vector<bool> useConstraint(header.hyperedges), useVariable(header.vertices);
+    for (std::uint64_t e = 0; e < header.hyperedges; ++e) useConstraint[e] = hypergraph.isActive(e);
+    for (std::uint64_t v = 0; v < header.vertices; ++v) useVariable[v] = hypergraph.isUsable(v);
+    std::vector<int> forcedList(forced.begin(), forced.end());
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    writeBytes(file, hyperedges.rawOffsets().data(), hyperedges.rawOffsets().size() * sizeof(std::size_t));
+    writeBytes(file, hyperedges.rawIndices().data(), hyperedges.entries() * sizeof(int));
+    writeBytes(file, incidences.rawOffsets().data(), incidences.rawOffsets().size() * sizeof(std::size_t));
+    writeBytes(file, incidences.rawIndices().data(), incidences.entries() * sizeof(int));
+    writeBitmap(file, useConstraint);
+    writeBitmap(file, useVariable);
+    writeBytes(file, forcedList.data(), forcedList.size() * sizeof(int));
+    writeBytes(file, originalIds.data(), originalIds.size() * sizeof(int));
+
+    if (!file) {
+        throw std::runtime_error("Failed to write file: " + filename);
+    }
+}
+
+std::vector<int> liftSolution(const Kernel& kernel, const std::vector<int>& solution){
+    std::vector<int> lifted(kernel.forced);
+    lifted.insert(lifted.end(), solution.begin(), solution.end());
+    if (!kernel.originalIds.empty()) {
+        for (int& v : lifted) v = kernel.originalIds[v];
+    }
+    std::sort(lifted.begin(), lifted.end());
+    lifted.erase(std::unique(lifted.begin(), lifted.end()), lifted.end());
+    return lifted;
+}
+
+Kernel readKernel(const std::string& filename){
+    MappedFile file(filename);
+    SnapshotHeader header = readHeader(file);
+
+    SnapshotCursor cursor(file.begin() + sizeof(SnapshotHeader));
+    CSR hyperedges = readRows(cursor, header.hyperedges, header.entries, header.vertices);
+    CSR incidences = readRows(cursor, header.vertices, header.entries, header.hyperedges);
+    std::vector<bool> useConstraint = readBitmap(cursor, header.hyperedges);
+    std::vector<bool> useVariable = readBitmap(cursor, header.vertices);
+    const int* forced = cursor.take<int>(header.forced);
+    const int* originalIds = cursor.take<int>(header.vertices);
+    for (std::uint64_t i = 0; i < header.forced; ++i) {
+        if (forced[i] < 0 || static_cast<std::uint64_t>(forced[i]) >= header.vertices) throw std::runtime_error("Corrupt kernel snapshot");
+    }
+    for (std::uint64_t v = 0; v < header.vertices; ++v) {
+        if (originalIds[v] < 0) throw std::runtime_error("Corrupt kernel snapshot");
+    }
+
+    return Kernel{
+        Hypergraph(std::move(hyperedges), std::move(incidences), std::move(useConstraint), std::move(useVariable)),
+        std::vector<int>(forced, forced + header.forced),
+        std::vector<int>(originalIds, originalIds + header.vertices)
+    };
+}
+
+bool kernelIsCurrent(const std::string& filename, const std::string& source){
+    try {
+        MappedFile file(filename);
+        SnapshotHeader header = readHeader(file);
+        SnapshotHeader current = {};
+        sourceStamp(source, current);
+        return header.sourceSize == current.sourceSize && header.sourceTime == current.sourceTime && header.sourcePath == current.sourcePath;
+    } catch (const std::exception&) {
+        return false; // Missing, foreign or broken snapshots are simply rebuilt
+    }
+}
+
+Kernel loadOrReduceKernel(const std::string& instance, const std::string& cacheDir){
+    // Instances of the same name in different directories get snapshots of their own
+    std::ostringstream snapshotName;
+    snapshotName << baseName(instance) << "." << std::hex << std::setw(16) << std::setfill('0') << canonicalPathHash(instance) << ".kernel";
+    std::string snapshot = cacheDir + "/" + snapshotName.str();
+    if (kernelIsCurrent(snapshot, instance)) return readKernel(snapshot);
+
+    auto hypergraph = readHypergraphFromFile(instance);
+    std::set<int> forced;
+    hypergraph.reduceExhaustively(forced, false);
+
+    std::vector<int> originalIds(hypergraph.numVertices());
+    for (int v = 0; v < hypergraph.numVertices(); ++v) originalIds[v] = v;
+
+    // Written under a private name and renamed, so readers only ever see complete snapshots
+    static std::atomic<unsigned> written(0);
+    std::string partial = snapshot + "." + std::to_string(getpid()) + "." + std::to_string(written++) + ".tmp";
+    writeKernel(partial, hypergraph, forced, originalIds, instance);
+    if (std::rename(partial.c_str(), snapshot.c_str()) != 0) {
+        std::remove(partial.c_str());
+        throw std::runtime_error("Could not store kernel snapshot " + snapshot);
+    }
+
+    return Kernel{std::move(hypergraph), std::vector<int>(forced.begin(), forced.end()), std::move(originalIds)};
+}
@@ -0,0 +1,38 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <string>
+#include <vector>
+#include <set>
+
+#include "hypergraph2.h"
+
+// A reduced instance together with what the reductions already decided
+struct Kernel {
+    Hypergraph hypergraph;
+    std::vector<int> forced;        // Sorted, 0-based vertices chosen by the reductions
+    std::vector<int> originalIds;   // Vertex i of the hypergraph is vertex originalIds[i] of the instance
+};
+
+// Full solution of the instance: solution of the kernel's hypergraph plus the forced vertices,
+// in the ids of the instance
+std::vector<int> liftSolution(const Kernel& kernel, const std::vector<int>& solution);
+
+// Binary snapshot of a Kernel: a fixed header followed by both CSR arrays, the constraint and
+// variable bitmaps, the forced vertices and the id mapping, every array 8-byte aligned in native
+// byte order. Reading maps the file and copies the arrays as they are, nothing is parsed.
+// The header records size, modification time (in nanoseconds) and a hash of the canonical path
+// of the source instance, so stale snapshots and those of other files can be detected.
+void writeKernel(const std::string& filename, const Hypergraph& hypergraph, const std::set<int>& forced, const std::vector<int>& originalIds, const std::string& source);
+Kernel readKernel(const std::string& filename);
+
+// Whether filename is a snapshot of the current version of source
+bool kernelIsCurrent(const std::string& filename, const std::string& source);
+
+// Reads the kernel of instance from cacheDir, or reads and reduces instance and stores its
+// snapshot there for the next run. Snapshots are named after the instance and a hash of its
+// canonical path, so instances of the same name in different directories do not
+// collide. Concurrent callers never see a partially written snapshot.
+Kernel loadOrReduceKernel(const std::string& instance, const std::string& cacheDir);
+
+#endif // SNAPSHOT_H
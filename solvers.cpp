@@ -0,0 +1,409 @@
+#include "solvers.h"
+
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <array>
+#include <fstream>
+#include <sstream>
+#include <regex>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <csignal>
+#include <sys/stat.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cerrno>
+#include <cmath>
+#include <algorithm>
+
+#include "graph.h"
+#include "parser.h"
+#include "subprocess.h"
+#include "exact.h"
+#include "localsearch.h"
+#include "portfolio.h"
+#include "components.h"
+#include "highs_api.h"
+#include "profile.h"
+
+std::string exec(const std::string& command) {
+    std::array<char, 128> buffer;
+    std::string result;
+    
+    // Define the correct type for the deleter
+    auto pclose_deleter = [](FILE* f) { pclose(f); };
+
+    // Open a pipe to run the command
+    std::unique_ptr<FILE, decltype(pclose_deleter)> pipe(popen(command.c_str(), "r"), pclose_deleter);
+    
+    if (!pipe) {
+        throw std::runtime_error("popen() failed!");
+    }
+    
+    // Read the output into the result string
+    while (fgets(buffer.data(), buffer.size(), pipe.get()) != nullptr) {
+        result += buffer.data();
+    }
+    
+    return result;
+}
+
+std::vector<int> readJsonArray(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open the file!");
+    }
+
+    std::string line;
+    std::getline(file, line); 
+    file.close();
+
+    // Check for surrounding brackets
+    if (line.front() != '[' || line.back() != ']') {
+        throw std::runtime_error("Invalid JSON array format!");
+    }
+
+    // Remove the brackets
+    line = line.substr(1, line.size() - 2);
+
+    std::vector<int> result;
+    std::stringstream ss(line);
+    std::string item;
+
+    // Parse each element separated by commas
+    while (std::getline(ss, item, ',')) {
+        try {
+            result.push_back(std::stoi(item));
+        } catch (const std::invalid_argument& e) {
+            throw std::runtime_error("Invalid number in JSON array!");
+        }
+    }
+
+    return result;
+}
+
+void outputSolution(const std::vector<int>& solution){
+    std::cout << solution.size() << std::endl;
+    for (auto elem : solution){
+        std::cout << elem + 1 << std::endl; // Return to 1-based index from 0-based
+    }
+}
+
+std::pair<double, double> parseReport(const std::string& report, const std::string& solver){
+    std::pair<double, double> result = {-1, -1}; // Default values if parsing fails
+
+    if (solver == "highs"){
+        std::regex primalBoundRegex(R"(Primal bound\s+(\d+\.?\d*))");
+        std::regex timingRegex(R"(Timing\s+([\d\.]+)\s+\(total\))");
+        
+        std::smatch match;
+
+        // Extract primal bound
+        if (std::regex_search(report, match, primalBoundRegex) && match.size() > 1) {
+            result.first = std::stod(match[1]);
+        }
+
+        // Extract total time
+        if (std::regex_search(report, match, timingRegex) && match.size() > 1) {
+            result.second = std::stod(match[1]);
+        }
+    } else if (solver == "scip"){
+        std::regex primalBoundRegex(R"(Primal Bound\s+:\s+([+-]?\d+\.?\d*(e[+-]?\d+)?))");
+        std::regex timingRegex(R"(Solving Time \(sec\)\s+:\s+([\d\.]+))");
+        
+        std::smatch match;
+
+        // Extract primal bound
+        if (std::regex_search(report, match, primalBoundRegex) && match.size() > 1) {
+            result.first = std::stod(match[1]);
+        }
+
+        // Extract total time
+        if (std::regex_search(report, match, timingRegex) && match.size() > 1) {
+            result.second = std::stod(match[1]);
+        }
+
+        return result;
+    } else if (solver == "gurobi") {
+        std::regex primalBoundRegex(R"(Best objective ([+-]?\d+\.?\d*(e[+-]?\d+)?)\,)");
+        std::regex timingRegex(R"(Explored \d+ nodes \(\d+ simplex iterations\) in ([\d\.]+) seconds)");
+        
+        std::smatch match;
+        
+        if (std::regex_search(report, match, primalBoundRegex) && match.size() > 1) {
+            result.first = std::stod(match[1]);
+        }
+        if (std::regex_search(report, match, timingRegex) && match.size() > 1) {
+            result.second = std::stod(match[1]);
+        }
+    }
+
+    return result;
+}
+
+
+bool isSolver(const std::string& solver){
+    static const std::vector<std::string> solvers = {"findminhs", "highs", "scip", "domsat", "nusc", "lp", "ilp_check", "gurobi", "uwrmaxsat", "exact", "localsearch", "portfolio", "highs_api"};
+    return std::find(solvers.begin(), solvers.end(), solver) != solvers.end();
+}
+
+namespace {
+
+// Seconds DomSAT and NuSC may overrun their own cutoff before they are killed
+const int localSearchGrace = 10;
+
+// Cutoff of the built-in local search when no time limit is given
+const double defaultLocalSearchCutoff = 10;
+
+using ModelWriter = std::function<void(std::ostream&)>;
+
+// Runs args once the model written by writeModel is available at modelPath. When streaming,
+// modelPath is a FIFO fed by a second thread while the solver reads it, so the model never hits the disk
+ProcessOutput runWithModel(const std::vector<std::string>& args, const std::string& modelPath, const ModelWriter& writeModel, bool stream, double timeLimit, const std::atomic<bool>* stop){
+    if (!stream) {
+        std::ofstream file(modelPath);
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open file: " + modelPath);
+        }
+        {
+            ProfileSpan span("export");
+            writeModel(file);
+            file.close();
+        }
+        return Subprocess(args).finish(timeLimit, stop);
+    }
+
+    if (mkfifo(modelPath.c_str(), 0600) != 0) {
+        throw std::runtime_error("Could not create FIFO " + modelPath);
+    }
+
+    Subprocess process(args);
+    std::atomic<bool> finished(false);
+    std::exception_ptr writeError;
+    Profile* profile = Profile::current();
+    std::thread writer([&]() {
+        // The export overlaps the solver, so its span lands on the writer's own track
+        ProfileScope scope(profile);
+        ProfileSpan span("export");
+        try {
+            writeToFifo(modelPath, writeModel, finished);
+        } catch (...) {
+            writeError = std::current_exception();
+        }
+    });
+
+    ProcessOutput result;
+    try {
+        result = process.finish(timeLimit, stop);
+    } catch (...) {
+        process.kill(SIGKILL);
+        finished = true;
+        writer.join();
+        throw;
+    }
+    finished = true;
+    writer.join();
+
+    if (writeError) std::rethrow_exception(writeError);
+    return result;
+}
+
+// NuSC reads its input more than once and Gurobi is untested, both always get a regular file
+bool readsModelOnce(const std::string& solver){
+    return solver != "nusc" && solver != "gurobi";
+}
+
+// Last "o <size> [<time>]" line as printed by DomSAT, NuSC and UWrMaxSAT
+void parseLastO(const std::string& output, SolverResult& result){
+    std::regex lastORegex(R"((?:^|\n)o\s+(\d+)(?:[ \t]+([\d\.]+))?)");
+    auto lastOIt = std::sregex_iterator(output.begin(), output.end(), lastORegex);
+    auto lastOMatch = std::sregex_iterator();
+
+    for (auto it = lastOIt; it != lastOMatch; ++it) {
+        result.solutionSize = std::stod((*it)[1]);
+        if ((*it)[2].matched) result.time = std::stod((*it)[2]);
+    }
+}
+
+// Model of the "v" lines UWrMaxSAT prints with -m, either as literals or as one 0/1 string.
+// Variable i+1 is vertices[i]; the result is empty unless it hits every active hyperedge
+std::vector<int> parseMaxSATModel(const std::string& output, const Hypergraph& hypergraph, const std::vector<int>& vertices){
+    std::vector<char> chosen(hypergraph.numVertices(), 0);
+    std::istringstream lines(output);
+    std::string line;
+    bool found = false;
+    while (std::getline(lines, line)) {
+        if (line.size() < 2 || line[0] != 'v' || line[1] != ' ') continue;
+        found = true;
+
+        std::istringstream tokens(line.substr(2));
+        std::string token;
+        while (tokens >> token) {
+            if (token.size() == vertices.size() && token.find_first_not_of("01") == std::string::npos) {
+                for (size_t i = 0; i < token.size(); ++i) if (token[i] == '1') chosen[vertices[i]] = 1;
+                continue;
+            }
+            // Anything else that is not a literal of a variable (a split -bm string, a stray word)
+            // means the model was not understood, so no solution is reported
+            char* end = nullptr;
+            errno = 0;
+            long literal = std::strtol(token.c_str(), &end, 10);
+            if (errno != 0 || end == token.c_str() || *end != '\0') return {};
+            if (literal < -(long) vertices.size() || literal > (long) vertices.size()) return {};
+            if (literal > 0) chosen[vertices[literal - 1]] = 1;
+        }
+    }
+
+    std::vector<int> solution;
+    if (!found) return solution;
+    for (int e = 0; e < hypergraph.numHyperedges(); ++e) {
+        if (!hypergraph.isActive(e)) continue;
+        auto vertices = hypergraph.verticesOf(e);
+        if (std::none_of(vertices.begin(), vertices.end(), [&](int v) {return chosen[v];})) return solution;
+    }
+    for (int v = 0; v < hypergraph.numVertices(); ++v) {
+        if (chosen[v]) solution.push_back(v);
+    }
+    return solution;
+}
+
+} // namespace
+
+SolverResult runSolver(const std::string& solver, const std::string& graphFile, const Hypergraph& hypergraph, const SolverOptions& options){
+    if (options.components) return solveComponents(solver, graphFile, hypergraph, options);
+
+    SolverResult result;
+    auto start = std::chrono::steady_clock::now();
+
+    // Every run gets its own directory, so concurrent runs never share a model or solution file
+    TempDir temp;
+    ProcessOutput process;
+    bool stream = options.streamModel && readsModelOnce(solver);
+
+    if (solver == "findminhs"){
+        // Convert to hypergraph format for findminhs solver by Felerius (https://github.com/Felerius/findminhs)
+        auto graph = readGraphFromFile(graphFile);
+        std::string hypergraphFile = temp.file("model.hgr");
+        std::string solutionFile = options.solutionFile.empty() ? temp.file("solution.json") : options.solutionFile;
+
+        std::vector<std::string> args = {"./findminhs-linux64", "solve", "--solution", solutionFile, hypergraphFile, options.settingsFile};
+        process = runWithModel(args, hypergraphFile, [&](std::ostream& out) { graph.graphToHypergraph(out, options.exportThreads); }, stream, options.timeLimit, options.stop);
+
+        std::ifstream solution(solutionFile);
+        if (solution.is_open()) {
+            solution.close();
+            result.solutionSize = readJsonArray(solutionFile).size();
+        }
+    } else if (solver == "highs" || solver == "scip" || solver == "gurobi" || solver == "lp"){
+        // The solvers pick the format from the extension
+        std::string lpFile = temp.file("model.lp");
+        bool ILP = solver != "lp"; // lp solves the relaxation with SCIP
+
+        std::vector<std::string> args;
+        if (solver == "highs") args = {"./highs", lpFile};
+        else if (solver == "gurobi") args = {"gurobi_cl", "Threads=1", lpFile};
+        else args = {"scip", "-f", lpFile};
+        process = runWithModel(args, lpFile, [&](std::ostream& out) { hypergraph.writeHittingSetLP(out, ILP, options.exportThreads); }, stream, options.timeLimit, options.stop);
+
+        auto report = parseReport(process.output, solver == "lp" ? "scip" : solver);
+        result.solutionSize = report.first;
+        result.time = report.second;
+    } else if (solver == "ilp_check"){
+        auto graph = readGraphFromFile(graphFile);
+        std::string lpFile = temp.file("model.lp");
+
+        std::vector<std::string> args = {"scip", "-f", lpFile};
+        process = runWithModel(args, lpFile, [&](std::ostream& out) { graph.writeHittingSetILP_check(out, options.k, options.exportThreads); }, stream, options.timeLimit, options.stop);
+
+        std::regex infeasibleRegex(R"(Primal Bound\s*:\s*infeasible|problem infeasible)");
+        result.feasible = !std::regex_search(process.output, infeasibleRegex);
+    } else if (solver == "domsat" || solver == "nusc"){
+        // Convert to SAT format for DomSAT / NuSC
+        std::string SAT_file = temp.file("model.sat");
+
+        // Both take the cutoff themselves, NuSC additionally a seed. The hard limit only
+        // catches runs that never get to check their cutoff. Their cutoff is in whole seconds
+        std::string cutoff = std::to_string(static_cast<int>(std::ceil(options.timeLimit)));
+        std::vector<std::string> args = {solver == "domsat" ? "./DomSAT" : "./NuSC", SAT_file, cutoff};
+        if (solver == "nusc") args.push_back(options.seed);
+        double hardLimit = options.timeLimit > 0 ? options.timeLimit + localSearchGrace : 0;
+        process = runWithModel(args, SAT_file, [&](std::ostream& out) { hypergraph.hypergraphToSAT(out, options.exportThreads); }, stream, hardLimit, options.stop);
+
+        parseLastO(process.output, result);
+    } else if (solver == "uwrmaxsat"){
+        std::string maxsatFile = temp.file("model.maxsat");
+
+        std::vector<std::string> args = {"./uwrmaxsat", "-v0", "-no-bin", "-no-sat", "-no-par", "-maxpre-time=60", "-scip-cpu=800", "-scip-delay=400", "-m", "-bm", maxsatFile};
+        process = runWithModel(args, maxsatFile, [&](std::ostream& out) { hypergraph.writeMaxSAT(out, options.exportThreads); }, stream, options.timeLimit, options.stop);
+
+        parseLastO(process.output, result);
+        result.time = -1; // UWrMaxSAT does not print a time on its o lines
+
+        // The export only numbers live vertices, so the model is mapped back to the hypergraph
+        result.solution = parseMaxSATModel(process.output, hypergraph, hypergraph.maxSATVariables());
+        if (!result.solution.empty()) result.solutionSize = result.solution.size();
+    } else if (solver == "exact"){
+        // In-process, the search reduces and branches on its own copy
+        Hypergraph kernel = hypergraph;
+        ExactOptions exactOptions;
+        exactOptions.timeLimit = options.timeLimit;
+        exactOptions.knownLowerBound = options.lowerBound;
+        exactOptions.verbose = options.verbose;
+        auto exact = BranchAndReduce(kernel, exactOptions).solve();
+
+        result.solution = exact.solution;
+        result.solutionSize = exact.solution.size();
+        result.time = exact.time;
+        process.timedOut = !exact.optimal;
+        process.output = "Nodes: " + std::to_string(exact.nodes) + ", lower bound: " + std::to_string(exact.lowerBound) + "\n";
+    } else if (solver == "highs_api"){
+        // In-process through the HiGHS library, no model file and no output to parse
+        HighsApiOptions highsOptions;
+        highsOptions.timeLimit = options.timeLimit;
+        highsOptions.verbose = options.verbose;
+        highsOptions.stop = options.stop;
+        auto highs = solveWithHighsApi(hypergraph, highsOptions);
+
+        result.solution = highs.solution;
+        result.solutionSize = highs.objective < 0 ? -1 : highs.solution.size();
+        result.time = highs.time;
+        process.timedOut = !highs.optimal;
+        process.output = "Lower bound: " + std::to_string(highs.bound) + "\n";
+    } else if (solver == "localsearch"){
+        LocalSearchOptions searchOptions;
+        searchOptions.timeLimit = options.timeLimit > 0 ? options.timeLimit : defaultLocalSearchCutoff;
+        searchOptions.seed = std::stoul(options.seed);
+
+        // Improvements are reported as "o <size> <time>" lines, like DomSAT and NuSC do
+        LocalSearch search(hypergraph, searchOptions);
+        std::ostringstream lines;
+        search.setCallback([&](const std::vector<int>& solution, double time) {
+            lines << "o " << solution.size() << " " << time << "\n";
+        });
+        auto local = search.run();
+
+        result.solution = local.solution;
+        result.solutionSize = local.solution.size();
+        result.time = local.time;
+        process.output = lines.str();
+    } else if (solver == "portfolio"){
+        auto race = runPortfolio(hypergraph, options.portfolio.empty() ? defaultPortfolio() : options.portfolio, options);
+
+        result.solution = race.solution;
+        result.solutionSize = race.solutionSize;
+        result.time = race.time;
+        process.timedOut = !race.optimal;
+        process.output = race.log;
+        if (race.solutionSize >= 0) process.output += "Best: " + race.winner + ", lower bound: " + std::to_string(race.lowerBound) + "\n";
+    } else {
+        throw std::runtime_error("Unsupported solver: " + solver);
+    }
+
+    result.output = std::move(process.output);
+    result.timedOut = process.timedOut;
+    result.wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
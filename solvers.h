@@ -0,0 +1,49 @@
+#ifndef SOLVERS_H
+#define SOLVERS_H
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <atomic>
+
+#include "hypergraph2.h"
+
+struct SolverOptions {
+    double timeLimit = 0;       // Seconds, 0 means unlimited. Cutoff for local search, hard limit otherwise
+    std::string seed = "1";
+    std::string solutionFile;   // findminhs only, empty keeps the solution in the private temp directory
+    std::string settingsFile = "settings.json"; // findminhs only
+    int k = 0;                  // ilp_check only
+    int lowerBound = 0;         // Proven bound on the hypergraph handed over, used by exact and portfolio
+    std::vector<std::string> portfolio; // portfolio only, empty runs the default backends
+    bool components = false;    // Solve every connected component of the hypergraph on its own
+    int threads = 0;            // Components solved concurrently, 0 uses all hardware threads
+    int exportThreads = 1;      // Threads formatting the model file, 0 uses all hardware threads
+    bool streamModel = true;    // Hand the model over through a FIFO instead of a temporary file
+    bool verbose = false;
+    const std::atomic<bool>* stop = nullptr; // Ends a running solver early, as if its time limit had passed
+};
+
+struct SolverResult {
+    double solutionSize = -1;   // -1 if the solver did not report a solution
+    double time = -1;           // Time reported by the solver itself, -1 if not reported
+    double wallTime = 0;        // Measured around the whole call, including model export
+    bool feasible = true;       // ilp_check only
+    bool timedOut = false;      // Killed at the time limit, the result is the best one seen until then
+    std::vector<int> solution;  // 0-based, filled by the in-process solvers and uwrmaxsat
+    std::string output;         // Raw solver output
+};
+
+std::string exec(const std::string& command);
+std::vector<int> readJsonArray(const std::string& filename);
+void outputSolution(const std::vector<int>& solution);
+std::pair<double, double> parseReport(const std::string& report, const std::string& solver);
+
+bool isSolver(const std::string& solver);
+
+// Exports the (possibly reduced) hypergraph for the given solver, runs it and collects the result.
+// Runs are independent of each other and of the working directory, so they may run concurrently.
+// graphFile is only read again by the solvers that need the plain graph (findminhs, ilp_check).
+SolverResult runSolver(const std::string& solver, const std::string& graphFile, const Hypergraph& hypergraph, const SolverOptions& options);
+
+#endif // SOLVERS_H
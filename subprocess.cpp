@@ -0,0 +1,241 @@
+#include "subprocess.h"
+
+#include <stdexcept>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <cerrno>
+#include <cstring>
+#include <cstdlib>
+#include <csignal>
+#include <dirent.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+namespace {
+
+std::string systemError(const std::string& what){
+    return what + ": " + std::strerror(errno);
+}
+
+// Output stream buffer writing straight to a file descriptor
+class FdStreamBuf : public std::streambuf {
+private:
+    int fd;
+    char buffer[1 << 16];
+
+    bool flushBuffer(){
+        char* data = pbase();
+        std::size_t remaining = pptr() - pbase();
+        while (remaining > 0) {
+            ssize_t written = ::write(fd, data, remaining);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            data += written;
+            remaining -= written;
+        }
+        setp(buffer, buffer + sizeof(buffer));
+        return true;
+    }
+
+protected:
+    int overflow(int c) override{
+        if (!flushBuffer()) return traits_type::eof();
+        if (c != traits_type::eof()) {
+            *pptr() = c;
+            pbump(1);
+        }
+        return traits_type::not_eof(c);
+    }
+
+    int sync() override{
+        return flushBuffer() ? 0 : -1;
+    }
+
+public:
+    explicit FdStreamBuf(int fd) : fd(fd) {
+        setp(buffer, buffer + sizeof(buffer));
+    }
+};
+
+} // namespace
+
+TempDir::TempDir(){
+    const char* base = std::getenv("TMPDIR");
+    std::string pattern = std::string(base && *base ? base : "/tmp") + "/dsp-XXXXXX";
+
+    std::vector<char> name(pattern.begin(), pattern.end());
+    name.push_back('\0');
+    if (!mkdtemp(name.data())) {
+        throw std::runtime_error(systemError("Could not create temporary directory " + pattern));
+    }
+    path = name.data();
+}
+
+TempDir::~TempDir(){
+    // Only files are ever created in here
+    if (DIR* dir = opendir(path.c_str())) {
+        struct dirent* entry;
+        while ((entry = readdir(dir)) != nullptr) {
+            std::string name = entry->d_name;
+            if (name == "." || name == "..") continue;
+            unlink(file(name).c_str());
+        }
+        closedir(dir);
+    }
+    rmdir(path.c_str());
+}
+
+Subprocess::Subprocess(const std::vector<std::string>& args){
+    if (args.empty()) throw std::runtime_error("Subprocess needs a program to run");
+
+    // Everything the child needs is prepared before fork, other threads may hold locks
+    std::vector<char*> argv;
+    for (const auto& arg : args) argv.push_back(const_cast<char*>(arg.c_str()));
+    argv.push_back(nullptr);
+
+    // Close-on-exec, so processes forked concurrently by other threads do not keep the write end open
+    int fds[2];
+    if (pipe2(fds, O_CLOEXEC) != 0) throw std::runtime_error(systemError("pipe() failed"));
+
+    // The child reports a failed exec through a second pipe that a successful exec closes
+    int errorFds[2];
+    if (pipe2(errorFds, O_CLOEXEC) != 0) {
+        close(fds[0]);
+        close(fds[1]);
+        throw std::runtime_error(systemError("pipe() failed"));
+    }
+
+    pid = fork();
+    if (pid < 0) {
+        for (int fd : {fds[0], fds[1], errorFds[0], errorFds[1]}) close(fd);
+        throw std::runtime_error(systemError("fork() failed"));
+    }
+
+    if (pid == 0) {
+        setpgid(0, 0);
+        dup2(fds[1], STDOUT_FILENO);
+        execvp(argv[0], argv.data());
+        int error = errno;
+        ssize_t ignored = ::write(errorFds[1], &error, sizeof(error));
+        (void)ignored;
+        _exit(127);
+    }
+
+    setpgid(pid, pid); // Also from the parent, so kill() cannot race the child's own call
+    close(fds[1]);
+    close(errorFds[1]);
+    outFd = fds[0];
+
+    int error = 0;
+    ssize_t bytes;
+    while ((bytes = read(errorFds[0], &error, sizeof(error))) < 0 && errno == EINTR) {}
+    close(errorFds[0]);
+    if (bytes > 0) {
+        waitpid(pid, nullptr, 0);
+        pid = -1;
+        close(outFd);
+        outFd = -1;
+        errno = error;
+        throw std::runtime_error(systemError("Could not run " + args[0]));
+    }
+}
+
+Subprocess::~Subprocess(){
+    if (pid > 0) {
+        kill(SIGKILL);
+        waitpid(pid, nullptr, 0);
+    }
+    if (outFd >= 0) close(outFd);
+}
+
+void Subprocess::kill(int signal){
+    if (pid > 0) ::kill(-pid, signal);
+}
+
+ProcessOutput Subprocess::finish(double timeLimit, const std::atomic<bool>* stop){
+    using Clock = std::chrono::steady_clock;
+    const auto killGrace = std::chrono::seconds(3);
+    const int stopPollMs = 50;
+
+    ProcessOutput result;
+    auto deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(timeLimit));
+    bool terminated = false;
+    bool killed = false;
+    char buffer[4096];
+
+    while (true) {
+        // After SIGTERM the grace period runs, whatever started it
+        bool hasDeadline = timeLimit > 0 || terminated;
+        int timeout = -1;
+        if (!killed && hasDeadline) {
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count();
+            timeout = static_cast<int>(std::max<long long>(left, 0));
+        }
+        if (!terminated && stop) timeout = timeout < 0 ? stopPollMs : std::min(timeout, stopPollMs);
+
+        pollfd fd = {outFd, POLLIN, 0};
+        int ready = poll(&fd, 1, timeout);
+        if (ready < 0 && errno != EINTR) throw std::runtime_error(systemError("poll() failed"));
+
+        if (ready > 0) {
+            ssize_t bytes = read(outFd, buffer, sizeof(buffer));
+            if (bytes > 0) {
+                result.output.append(buffer, bytes);
+                continue;
+            }
+            if (bytes == 0) break; // Every writer is gone
+            if (errno != EINTR && errno != EAGAIN) break;
+        }
+
+        bool expired = hasDeadline && Clock::now() >= deadline;
+        bool stopped = !terminated && stop && *stop;
+        if (!killed && (expired || stopped)) {
+            if (!terminated) {
+                kill(SIGTERM);
+                terminated = true;
+                result.timedOut = true;
+                deadline = Clock::now() + killGrace;
+            } else {
+                kill(SIGKILL);
+                killed = true;
+            }
+        }
+    }
+
+    int status = 0;
+    while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {}
+    pid = -1;
+    result.exitStatus = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+    return result;
+}
+
+void writeToFifo(const std::string& path, const std::function<void(std::ostream&)>& write, const std::atomic<bool>& stop){
+    static std::once_flag ignoreSigpipe;
+    std::call_once(ignoreSigpipe, []() { std::signal(SIGPIPE, SIG_IGN); });
+
+    // Opening for writing without a reader fails with ENXIO instead of blocking, so a solver
+    // that dies before opening its model cannot hang us
+    int fd = -1;
+    while (fd < 0) {
+        fd = open(path.c_str(), O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+        if (fd >= 0) break;
+        if (errno != ENXIO && errno != EINTR) throw std::runtime_error(systemError("Could not open " + path));
+        if (stop) return;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_NONBLOCK);
+
+    {
+        FdStreamBuf buffer(fd);
+        std::ostream stream(&buffer);
+        write(stream);
+        stream.flush();
+    }
+    close(fd);
+}
@@ -0,0 +1,58 @@
+#ifndef SUBPROCESS_H
+#define SUBPROCESS_H
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <atomic>
+#include <ostream>
+#include <sys/types.h>
+
+// Private directory below $TMPDIR (or /tmp), removed with everything in it on destruction
+class TempDir {
+private:
+    std::string path;
+
+public:
+    TempDir();
+    ~TempDir();
+
+    TempDir(const TempDir&) = delete;
+    TempDir& operator=(const TempDir&) = delete;
+
+    const std::string& getPath() const {return path;};
+    std::string file(const std::string& name) const {return path + "/" + name;};
+};
+
+struct ProcessOutput {
+    std::string output;         // Everything the process wrote to stdout
+    int exitStatus = -1;        // Exit code, or -1 if it was killed by a signal
+    bool timedOut = false;
+};
+
+// Child process started without a shell (argv[0] is looked up in PATH) in its own process group,
+// with stdout captured through a pipe
+class Subprocess {
+private:
+    pid_t pid = -1;
+    int outFd = -1;
+
+public:
+    explicit Subprocess(const std::vector<std::string>& args);
+    ~Subprocess();
+
+    Subprocess(const Subprocess&) = delete;
+    Subprocess& operator=(const Subprocess&) = delete;
+
+    // Collects stdout until the process exits. After timeLimit seconds (0 means unlimited), or once
+    // stop is set, the whole process group gets SIGTERM, and SIGKILL if it is still around a few seconds later
+    ProcessOutput finish(double timeLimit, const std::atomic<bool>* stop = nullptr);
+    void kill(int signal);
+};
+
+// Opens the FIFO at path once a reader has attached and runs write on a stream into it.
+// Gives up without writing if stop becomes true first; a reader that goes away early only
+// ends the write, it does not raise SIGPIPE
+void writeToFifo(const std::string& path, const std::function<void(std::ostream&)>& write, const std::atomic<bool>& stop);
+
+#endif // SUBPROCESS_H
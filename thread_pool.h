@@ -0,0 +1,43 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+
+// Fixed number of worker threads draining a FIFO of tasks.
+// An exception thrown by a task is kept and rethrown by the next wait().
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable taskAvailable;
+    std::condition_variable allDone;
+    int running = 0;
+    bool stopping = false;
+    std::exception_ptr error;
+
+    void work();
+
+public:
+    // threads <= 0 uses the number of hardware threads
+    explicit ThreadPool(int threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(std::function<void()> task);
+
+    // Blocks until the queue is empty and no task is running
+    void wait();
+
+    int size() const {return workers.size();};
+};
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,59 @@
+#include "writer.h"
+
+#include "profile.h"
+
+namespace {
+
+// "00" to "99", so every division by 100 yields two digits at once
+const char digitPairs[] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+} // namespace
+
+void TextWriter::flush(){
+    if (!out || used == 0) return;
+    out->write(buffer.data(), used);
+    if (Profile* profile = Profile::current()) profile->counters[Profile::BytesWritten] += used;
+    used = 0;
+}
+
+void TextWriter::write(const char* text, std::size_t length){
+    if (out && length > buffer.size()) {
+        flush();
+        out->write(text, length);
+        if (Profile* profile = Profile::current()) profile->counters[Profile::BytesWritten] += length;
+        return;
+    }
+    reserve(length);
+    std::memcpy(buffer.data() + used, text, length);
+    used += length;
+}
+
+// Digits are produced back to front into a small scratch array, then copied in one piece
+void TextWriter::writeUnsigned(std::uint64_t value){
+    char scratch[20];
+    char* end = scratch + sizeof(scratch);
+    char* p = end;
+
+    while (value >= 100) {
+        unsigned pair = value % 100;
+        value /= 100;
+        p -= 2;
+        std::memcpy(p, digitPairs + 2 * pair, 2);
+    }
+    if (value >= 10) {
+        p -= 2;
+        std::memcpy(p, digitPairs + 2 * value, 2);
+    } else {
+        *--p = '0' + value;
+    }
+
+    std::size_t length = end - p;
+    reserve(length);
+    std::memcpy(buffer.data() + used, p, length);
+    used += length;
+}
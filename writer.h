@@ -0,0 +1,116 @@
+#ifndef WRITER_H
+#define WRITER_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <type_traits>
+#include <memory>
+#include <algorithm>
+
+#include "thread_pool.h"
+
+// Buffered text output shared by all model writers. Text is collected in a large buffer and
+// handed to the stream in big blocks, integers are formatted two digits at a time without
+// going through the locale machinery of operator<<. Whatever is left is written on destruction.
+// Without a stream the writer only collects, growing its buffer as needed.
+class TextWriter {
+private:
+    std::ostream* out = nullptr;
+    std::vector<char> buffer;
+    std::size_t used = 0;
+
+    // Makes room for bytes more characters
+    void reserve(std::size_t bytes){
+        if (buffer.size() - used >= bytes) return;
+        if (out) flush();
+        if (buffer.size() - used < bytes) buffer.resize(std::max(2 * buffer.size(), used + bytes));
+    }
+
+    void writeUnsigned(std::uint64_t value);
+
+public:
+    explicit TextWriter(std::ostream& out, std::size_t capacity = 1 << 20) : out(&out), buffer(capacity) {}
+    explicit TextWriter(std::size_t capacity = 1 << 16) : buffer(capacity) {}
+    ~TextWriter() {flush();};
+
+    TextWriter(const TextWriter&) = delete;
+    TextWriter& operator=(const TextWriter&) = delete;
+
+    void flush();
+    void write(const char* text, std::size_t length);
+
+    // Appends what a collecting writer holds and empties it
+    void append(TextWriter& block){
+        write(block.buffer.data(), block.used);
+        block.used = 0;
+    }
+
+    TextWriter& operator<<(char c){
+        reserve(1);
+        buffer[used++] = c;
+        return *this;
+    }
+
+    TextWriter& operator<<(const char* text){
+        write(text, std::strlen(text));
+        return *this;
+    }
+
+    TextWriter& operator<<(const std::string& text){
+        write(text.data(), text.size());
+        return *this;
+    }
+
+    template <typename T, typename = std::enable_if_t<std::is_integral<T>::value && !std::is_same<T, char>::value && !std::is_same<T, bool>::value>>
+    TextWriter& operator<<(T value){
+        if (std::is_signed<T>::value && value < 0) {
+            *this << '-';
+            writeUnsigned(-static_cast<std::uint64_t>(value));
+        } else {
+            writeUnsigned(static_cast<std::uint64_t>(value));
+        }
+        return *this;
+    }
+};
+
+// Items below this count are always written by the calling thread
+const std::size_t parallelWriteThreshold = 1 << 15;
+const std::size_t parallelWriteBlock = 4096;
+
+// Calls writeItem(writer, i) for i = 0 .. count-1, and the output is always the same as doing it
+// in this order. With threads other than 1 (<= 0 uses all hardware threads), blocks of items are formatted concurrently into private
+// buffers, a bounded number at a time, and appended to file in order as each round finishes.
+// writeItem must only read shared state, scratch space belongs in thread_local storage.
+template <typename WriteItem>
+void writeItems(TextWriter& file, std::size_t count, int threads, WriteItem&& writeItem){
+    if (threads == 1 || count < parallelWriteThreshold) {
+        for (std::size_t i = 0; i < count; ++i) writeItem(file, i);
+        return;
+    }
+
+    ThreadPool pool(threads);
+    std::vector<std::unique_ptr<TextWriter>> blocks(2 * pool.size());
+    for (auto& block : blocks) block = std::make_unique<TextWriter>();
+
+    std::size_t roundSize = blocks.size() * parallelWriteBlock;
+    for (std::size_t round = 0; round < count; round += roundSize) {
+        for (std::size_t b = 0; b < blocks.size(); ++b) {
+            std::size_t begin = std::min(count, round + b * parallelWriteBlock);
+            std::size_t end = std::min(count, begin + parallelWriteBlock);
+            if (begin == end) break;
+
+            TextWriter* block = blocks[b].get();
+            pool.submit([&writeItem, block, begin, end]() {
+                for (std::size_t i = begin; i < end; ++i) writeItem(*block, i);
+            });
+        }
+        pool.wait();
+
+        for (auto& block : blocks) file.append(*block);
+    }
+}
+
+#endif // WRITER_H